@@ -0,0 +1,117 @@
+/**
+ * @file logcpp_bench_strings.cpp
+ * @brief Benchmark: Records made of string literals, C-strings, string_views and strings, compared to pumping each through a std::istringstream
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+    LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+    Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+    Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 3 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+    USA
+*/
+
+
+#include "severity_logger.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+
+namespace {
+
+/**
+ * @brief A sink that discards all records
+ */
+class null_sink
+	:	public logcpp::sink
+{
+public:
+	virtual void write( const logcpp::record_view& ) {}
+	virtual void flush() {}
+};
+
+/**
+ * @brief A C-string inserted like operator<<( logstreambuf&, const char* ) did before strings were inserted directly
+ */
+struct pumped {
+	const char* text;
+};
+
+} // namespace
+
+template<>
+struct logcpp::formatter< pumped > {
+	static void format( logstreambuf& out, const pumped& value ) {
+		std::istringstream in( value.text );
+		static_cast< std::ostream& >( out ) << in.rdbuf();
+	}
+};
+
+
+namespace {
+
+/**
+ * @returns The average time of a record in nanoseconds
+ * @param records The amount of records to log
+ * @param record Logs one record to a logger
+ */
+template< typename F >
+double measure( std::size_t records, F record ) {
+    null_sink out;
+    logcpp::severity_logger log( &out );
+    for ( std::size_t i = 0; i < records / 10; i++ ) {  // Warm up
+        record( log );
+    }
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for ( std::size_t i = 0; i < records; i++ ) {
+        record( log );
+    }
+    const std::chrono::duration< double, std::nano > elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / static_cast< double >( records );
+}
+
+} // namespace
+
+
+int main( int argc, char** argv ) {
+    const std::size_t records = ( argc > 1 ? std::strtoul( argv[1], nullptr, 10 ) : 200000 );
+    const std::string user( "nobody" );
+    const char* volatile host = "localhost";   // Not known at compile time
+    const std::string_view action( "login" );
+
+    std::printf( "%zu records of 8 strings and one std::string each\n", records );
+
+    std::printf( "%-24s %8.1f ns/record\n", "string literals", measure( records, [&]( logcpp::severity_logger& log ) {
+        log << logcpp::normal << "user " << user << " from " << "host " << "did " << "something " << "with " << "a " << "result" << logcpp::endrec;
+    } ) );
+    std::printf( "%-24s %8.1f ns/record\n", "const char*", measure( records, [&]( logcpp::severity_logger& log ) {
+        const char* h = host;
+        log << logcpp::normal << h << user << h << h << h << h << h << h << h << logcpp::endrec;
+    } ) );
+    std::printf( "%-24s %8.1f ns/record\n", "std::string_view", measure( records, [&]( logcpp::severity_logger& log ) {
+        log << logcpp::normal << action << user << action << action << action << action << action << action << action << logcpp::endrec;
+    } ) );
+    std::printf( "%-24s %8.1f ns/record\n", "istringstream (before)", measure( records, [&]( logcpp::severity_logger& log ) {
+        log << logcpp::normal << pumped{ "user " } << user << pumped{ " from " } << pumped{ "host " } << pumped{ "did " } << pumped{ "something " }
+            << pumped{ "with " } << pumped{ "a " } << pumped{ "result" } << logcpp::endrec;
+    } ) );
+    return 0;
+}
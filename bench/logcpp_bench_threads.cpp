@@ -0,0 +1,96 @@
+/**
+ * @file logcpp_bench_threads.cpp
+ * @brief Benchmark: Records per second of stdlog with 1 to 8 threads logging to the file channel at once
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+    LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+    Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+    Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 3 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+    USA
+*/
+
+
+#include "log.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace {
+
+/**
+ * @returns The records per second of some threads each logging an amount of records to stdlog
+ * @param async Wether the channels are asynchronous. Writing the queued records is part of the measurement.
+ */
+double measure( unsigned int threads, std::size_t records, bool async ) {
+    if ( async ) {
+        logcpp::globallog::enable_async();
+    }
+    std::vector< std::thread > workers;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for ( unsigned int t = 0; t < threads; t++ ) {
+        workers.emplace_back( [t, records] {
+            for ( std::size_t i = 0; i < records; i++ ) {
+                stdlog << logcpp::warning << "thread " << t << " record " << i << " value " << 0.5 * static_cast< double >( i ) << logcpp::endrec;
+            }
+        } );
+    }
+    for ( std::thread& worker : workers ) {
+        worker.join();
+    }
+    if ( async ) {
+        logcpp::globallog::disable_async();  // Waits until all queued records are written
+    }
+    const std::chrono::duration< double > elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast< double >( threads * records ) / elapsed.count();
+}
+
+} // namespace
+
+
+int main( int argc, char** argv ) {
+    const std::size_t records = ( argc > 1 ? std::strtoul( argv[1], nullptr, 10 ) : 100000 );
+    const std::string file = ( argc > 2 ? argv[2] : "./logcpp_bench_threads.log" );
+    const unsigned int thread_counts[] = { 1, 2, 4, 8 };
+
+    logcpp::globallog::set_logfile( file );
+    logcpp::globallog::enable_file_log();
+    logcpp::globallog::disable_console_log();
+
+    std::printf( "%zu records per thread to %s (hardware threads: %u)\n", records, file.c_str(), std::thread::hardware_concurrency() );
+    std::printf( "%-8s", "threads" );
+    for ( unsigned int threads : thread_counts ) {
+        std::printf( " %10u", threads );
+    }
+    std::printf( "   (records/s)\n" );
+
+    for ( int async = 0; async < 2; async++ ) {
+        std::printf( "%-8s", async ? "async" : "sync" );
+        for ( unsigned int threads : thread_counts ) {
+            std::printf( " %10.0f", measure( threads, records, async != 0 ) );
+            std::fflush( stdout );
+        }
+        std::printf( "\n" );
+    }
+    std::remove( file.c_str() );
+    return 0;
+}
@@ -0,0 +1,357 @@
+/**
+ * @file async_sink.cpp
+ * @brief A sink that queues records for a dedicated writer thread
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+    LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+    Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+    Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 3 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+    USA
+*/
+
+
+#include "async_sink.hpp"
+#include "record_buffer.hpp"
+
+#include <cstring>
+#include <string>
+
+
+namespace logcpp {
+
+async_sink::async_sink( sink* target, std::size_t depth, std::size_t batch_size )
+    :   m_target( target )
+    ,   m_mask( 0 )
+    ,   m_batch_size( batch_size > 0 ? batch_size : 1 )
+    ,   m_slots()
+    ,   m_enqueue_pos( 0 )
+    ,   m_dequeue_pos( 0 )
+    ,   m_completed( 0 )
+    ,   m_writer_sleeping( false )
+    ,   m_stop( false )
+    ,   m_policy( overflow_block )
+    ,   m_severity_threshold( error )
+    ,   m_report_interval_ms( 1000 )
+    ,   m_last_report( std::chrono::steady_clock::now() )
+    ,   m_lock()
+    ,   m_wakeup()
+    ,   m_progress()
+    ,   m_writer()
+{
+    std::size_t size = 2;
+    while ( size < depth ) {
+        size <<= 1;
+    }
+    m_mask = size - 1;
+
+    for ( std::size_t i = 0; i <= LOGCPP_ASYNC_MAX_SEVERITIES; i++ ) {
+        m_dropped[i].store( 0, std::memory_order_relaxed );
+        m_reported[i] = 0;
+    }
+
+    m_slots.reset( new slot[size] );
+    for ( std::size_t i = 0; i < size; i++ ) {
+        m_slots[i].sequence.store( i, std::memory_order_relaxed );
+        m_slots[i].block = nullptr;
+        m_slots[i].block_size = 0;
+    }
+
+    m_writer = std::thread( &async_sink::run, this );
+}
+
+
+async_sink::~async_sink() {
+    m_stop.store( true, std::memory_order_release );
+    {
+        std::lock_guard< std::mutex > guard( m_lock );
+        m_wakeup.notify_one();
+    }
+    m_writer.join();
+}
+
+
+bool async_sink::try_enqueue( const record_view& record ) {
+    std::size_t pos = m_enqueue_pos.load( std::memory_order_relaxed );
+    slot* s = nullptr;
+
+    for (;;) {
+        s = &m_slots[pos & m_mask];
+        std::size_t seq = s->sequence.load( std::memory_order_acquire );
+        std::ptrdiff_t diff = static_cast< std::ptrdiff_t >( seq ) - static_cast< std::ptrdiff_t >( pos );
+        if ( diff == 0 ) {
+            if ( m_enqueue_pos.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) {
+                break;
+            }
+        } else if ( diff < 0 ) {
+            return false;
+        } else {
+            pos = m_enqueue_pos.load( std::memory_order_relaxed );
+        }
+    }
+
+    std::size_t size = record.prefix_size + record.body_size;
+    char* target = s->data;
+    if ( size > LOGCPP_ASYNC_INLINE_SIZE ) {
+        s->block = block_pool::acquire( size, s->block_size );
+        target = s->block;
+    }
+    std::memcpy( target, record.prefix, record.prefix_size );
+    std::memcpy( target + record.prefix_size, record.body, record.body_size );
+    s->prefix_size = record.prefix_size;
+    s->size = size;
+    s->terminated = record.terminated;
+    s->severity = record.severity;
+
+    s->sequence.store( pos + 1, std::memory_order_release );
+    return true;
+}
+
+
+bool async_sink::take_next( bool write ) {
+    std::size_t pos = m_dequeue_pos.load( std::memory_order_relaxed );
+    slot* s = nullptr;
+
+    for (;;) {
+        s = &m_slots[pos & m_mask];
+        std::size_t seq = s->sequence.load( std::memory_order_acquire );
+        std::ptrdiff_t diff = static_cast< std::ptrdiff_t >( seq ) - static_cast< std::ptrdiff_t >( pos + 1 );
+        if ( diff == 0 ) {
+            if ( m_dequeue_pos.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) {
+                break;
+            }
+        } else if ( diff < 0 ) {
+            return false;
+        } else {
+            pos = m_dequeue_pos.load( std::memory_order_relaxed );
+        }
+    }
+
+    if ( write ) {
+        const char* data = s->block != nullptr ? s->block : s->data;
+        record_view record = { data, s->prefix_size, data + s->prefix_size, s->size - s->prefix_size, s->terminated, s->severity };
+        m_target->write( record );
+    } else {
+        count_dropped( s->severity );
+    }
+
+    if ( s->block != nullptr ) {
+        block_pool::release( s->block, s->block_size );
+        s->block = nullptr;
+        s->block_size = 0;
+    }
+
+    s->sequence.store( pos + m_mask + 1, std::memory_order_release );
+    return true;
+}
+
+
+void async_sink::wake_writer() {
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+    if ( m_writer_sleeping.load( std::memory_order_relaxed ) ) {
+        std::lock_guard< std::mutex > guard( m_lock );
+        m_wakeup.notify_one();
+    }
+}
+
+
+void async_sink::run() {
+    for (;;) {
+        std::size_t written = 0;
+        while ( written < m_batch_size && take_next( true ) ) {
+            written++;
+        }
+
+        report_dropped( false );
+
+        if ( written > 0 ) {
+            m_target->flush();
+            m_completed.fetch_add( written, std::memory_order_release );
+            std::lock_guard< std::mutex > guard( m_lock );
+            m_progress.notify_all();
+            continue;
+        }
+
+        if ( m_stop.load( std::memory_order_acquire ) ) {
+            if ( take_next( true ) ) {   // A producer may have finished its record after the last check
+                m_target->flush();
+                m_completed.fetch_add( 1, std::memory_order_release );
+                continue;
+            }
+            break;
+        }
+
+        m_writer_sleeping.store( true, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+
+        std::size_t pos = m_dequeue_pos.load( std::memory_order_relaxed );
+        bool pending = m_slots[pos & m_mask].sequence.load( std::memory_order_acquire ) == pos + 1;
+        if ( !pending ) {
+            std::unique_lock< std::mutex > lock( m_lock );
+            if ( !m_stop.load( std::memory_order_acquire ) ) {
+                m_wakeup.wait_for( lock, std::chrono::milliseconds( 100 ) );
+            }
+        }
+        m_writer_sleeping.store( false, std::memory_order_relaxed );
+    }
+
+    report_dropped( true );
+    m_target->flush();
+}
+
+
+void async_sink::count_dropped( int severity ) {
+    std::size_t index = 0;
+    if ( severity >= 0 && severity < LOGCPP_ASYNC_MAX_SEVERITIES ) {
+        index = static_cast< std::size_t >( severity ) + 1;
+    }
+    m_dropped[index].fetch_add( 1, std::memory_order_relaxed );
+}
+
+
+void async_sink::report_dropped( bool force ) {
+    long interval = m_report_interval_ms.load( std::memory_order_relaxed );
+    if ( interval <= 0 ) {
+        return;
+    }
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if ( !force && now - m_last_report < std::chrono::milliseconds( interval ) ) {
+        return;
+    }
+    m_last_report = now;
+
+    std::size_t total = 0;
+    std::string counts;
+    for ( std::size_t i = 0; i <= LOGCPP_ASYNC_MAX_SEVERITIES; i++ ) {
+        std::size_t dropped = m_dropped[i].load( std::memory_order_relaxed );
+        std::size_t count = dropped - m_reported[i];
+        m_reported[i] = dropped;
+        if ( count == 0 ) {
+            continue;
+        }
+        total += count;
+
+        if ( !counts.empty() ) {
+            counts += ", ";
+        }
+        if ( i == 0 ) {
+            counts += "none";
+        } else if ( i - 1 < static_cast< std::size_t >( SEVERITY_SIZE ) ) {
+            counts += DefaultSeverity::name( static_cast< default_severity_levels >( i - 1 ) );
+        } else {
+            counts += "severity " + std::to_string( i - 1 );
+        }
+        counts += ": " + std::to_string( count );
+    }
+
+    if ( total == 0 ) {
+        return;
+    }
+
+    std::string body = "liblogcpp: dropped " + std::to_string( total ) + " records while the queue was full (" + counts + ")";
+    record_view summary = { body.data(), 0, body.data(), body.size(), true, static_cast< int >( warning ) };
+    m_target->write( summary );
+    m_target->flush();
+}
+
+
+void async_sink::wait_for_progress() {
+    wake_writer();
+    std::unique_lock< std::mutex > lock( m_lock );
+    m_progress.wait_for( lock, std::chrono::milliseconds( 1 ) );
+}
+
+
+void async_sink::write( const record_view& record ) {
+    unsigned int attempts = 0;
+
+    while ( !try_enqueue( record ) ) {
+        switch ( m_policy.load( std::memory_order_relaxed ) ) {
+            case overflow_drop_newest:
+                count_dropped( record.severity );
+                return;
+            case overflow_drop_oldest:
+                if ( take_next( false ) ) {
+                    m_completed.fetch_add( 1, std::memory_order_release );
+                    continue;
+                }
+                break;  // The writer thread still holds the slot, so wait for it
+            case overflow_drop_below_severity:
+                if ( record.severity > m_severity_threshold.load( std::memory_order_relaxed ) ) {
+                    count_dropped( record.severity );
+                    return;
+                }
+                break;
+            default:
+                break;
+        }
+
+        if ( ++attempts < 64 ) {
+            wake_writer();
+            std::this_thread::yield();
+        } else {
+            wait_for_progress();
+        }
+    }
+    wake_writer();
+}
+
+
+void async_sink::flush() {}
+
+
+void async_sink::set_overflow_policy( overflow_policy policy, int severity_threshold ) {
+    m_severity_threshold.store( severity_threshold, std::memory_order_relaxed );
+    m_policy.store( policy, std::memory_order_relaxed );
+}
+
+
+void async_sink::set_drop_report_interval( std::chrono::milliseconds interval ) {
+    m_report_interval_ms.store( static_cast< long >( interval.count() ), std::memory_order_relaxed );
+}
+
+
+std::size_t async_sink::dropped( int severity ) const {
+    std::size_t index = 0;
+    if ( severity >= 0 && severity < LOGCPP_ASYNC_MAX_SEVERITIES ) {
+        index = static_cast< std::size_t >( severity ) + 1;
+    }
+    return m_dropped[index].load( std::memory_order_relaxed );
+}
+
+
+std::size_t async_sink::dropped_total() const {
+    std::size_t total = 0;
+    for ( std::size_t i = 0; i <= LOGCPP_ASYNC_MAX_SEVERITIES; i++ ) {
+        total += m_dropped[i].load( std::memory_order_relaxed );
+    }
+    return total;
+}
+
+
+void async_sink::drain() {
+    std::size_t target = m_enqueue_pos.load( std::memory_order_acquire );
+    wake_writer();
+
+    std::unique_lock< std::mutex > lock( m_lock );
+    while ( m_completed.load( std::memory_order_acquire ) < target ) {
+        m_progress.wait_for( lock, std::chrono::milliseconds( 10 ) );
+    }
+}
+
+
+} // namespace logcpp
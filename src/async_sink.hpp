@@ -0,0 +1,247 @@
+/**
+ * @file async_sink.hpp
+ * @brief A sink that queues records for a dedicated writer thread
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+	LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+	Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+	Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+	USA
+*/
+
+
+#pragma once
+
+#include "config.hpp"
+
+#include "severity_default.hpp"
+#include "sink.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+
+/**
+ * @def LOGCPP_ASYNC_INLINE_SIZE
+ * @brief Amount of bytes a slot of an async_sink holds inline. Larger records are copied to a pooled block.
+ */
+#ifndef LOGCPP_ASYNC_INLINE_SIZE
+#define LOGCPP_ASYNC_INLINE_SIZE 256
+#endif
+
+
+/**
+ * @def LOGCPP_ASYNC_MAX_SEVERITIES
+ * @brief Amount of severity values an async_sink counts dropped records for
+ */
+#ifndef LOGCPP_ASYNC_MAX_SEVERITIES
+#define LOGCPP_ASYNC_MAX_SEVERITIES 16
+#endif
+
+
+namespace logcpp {
+
+/**
+ * @brief What an async_sink does with a record, when its ring is full
+ */
+enum overflow_policy {
+	/**
+	 * @brief Wait until the writer thread frees a slot
+	 */
+	overflow_block,
+	/**
+	 * @brief Drop the record that is to be queued
+	 */
+	overflow_drop_newest,
+	/**
+	 * @brief Drop the oldest queued record to make room for the new one
+	 */
+	overflow_drop_oldest,
+	/**
+	 * @brief Drop the record, if it is less critical than a threshold (like debug below warning). Otherwise wait.
+	 */
+	overflow_drop_below_severity
+};
+
+
+/**
+ * @brief A sink that moves finished records into a bounded lock-free multi-producer ring
+ * @note A background thread drains the ring in batches to the target sink and flushes it once per batch.
+ * @note Any logger can be made asynchronous by constructing it with a pointer to an async_sink.
+ */
+class async_sink
+	:	public sink
+{
+public:
+	/**
+	 * @brief The default amount of records the ring can hold
+	 */
+	static const std::size_t default_depth = 4096;
+	/**
+	 * @brief The default amount of records written before the target is flushed
+	 */
+	static const std::size_t default_batch_size = 64;
+
+protected:
+	/**
+	 * @brief One record in the ring
+	 */
+	struct slot {
+		std::atomic< std::size_t > sequence;
+		std::size_t prefix_size;
+		std::size_t size;
+		bool terminated;
+		int severity;
+		char* block;
+		std::size_t block_size;
+		char data[LOGCPP_ASYNC_INLINE_SIZE];
+	};
+
+	sink* m_target;
+	std::size_t m_mask;
+	std::size_t m_batch_size;
+	std::unique_ptr< slot[] > m_slots;
+
+	alignas(64) std::atomic< std::size_t > m_enqueue_pos;
+	alignas(64) std::atomic< std::size_t > m_dequeue_pos;
+	alignas(64) std::atomic< std::size_t > m_completed;
+	std::atomic< bool > m_writer_sleeping;
+	std::atomic< bool > m_stop;
+
+	std::atomic< int > m_policy;
+	std::atomic< int > m_severity_threshold;
+	std::atomic< long > m_report_interval_ms;
+	std::atomic< std::size_t > m_dropped[LOGCPP_ASYNC_MAX_SEVERITIES + 1];
+	std::size_t m_reported[LOGCPP_ASYNC_MAX_SEVERITIES + 1];
+	std::chrono::steady_clock::time_point m_last_report;
+
+	std::mutex m_lock;
+	std::condition_variable m_wakeup;
+	std::condition_variable m_progress;
+	std::thread m_writer;
+
+	/**
+	 * @brief Try to move a record into the ring
+	 * @returns False, if the ring is full
+	 */
+	bool try_enqueue( const record_view& record );
+
+	/**
+	 * @brief Try to take the oldest record out of the ring
+	 * @param write Wether the record is written to the target or dropped
+	 * @returns False, if the ring is empty
+	 */
+	bool take_next( bool write );
+
+	/**
+	 * @brief Count a record that was dropped
+	 * @param severity The severity of the dropped record
+	 */
+	void count_dropped( int severity );
+
+	/**
+	 * @brief Write a summary record of all records dropped since the last summary to the target
+	 * @param force Write the summary, even if the report interval has not passed yet
+	 */
+	void report_dropped( bool force );
+
+	/**
+	 * @brief Wait for the writer thread to free a slot
+	 */
+	void wait_for_progress();
+
+	/**
+	 * @brief Wake up the writer thread, if it is sleeping
+	 */
+	void wake_writer();
+
+	/**
+	 * @brief The loop of the writer thread
+	 */
+	void run();
+
+public:
+	/**
+	 * @brief Constructor. Starts the writer thread.
+	 * @param target The sink all records are written to by the writer thread
+	 * @param depth The amount of records that can be queued. Rounded up to a power of two.
+	 * @param batch_size The amount of records written to the target before it is flushed
+	 */
+	explicit async_sink( sink* target, std::size_t depth = default_depth, std::size_t batch_size = default_batch_size );
+
+	async_sink( const async_sink& ) = delete;
+
+	/**
+	 * @brief Destructor. Writes all queued records to the target and stops the writer thread.
+	 */
+	virtual ~async_sink();
+
+	/**
+	 * @brief Queue a record for the writer thread. Waits for a free slot, if the ring is full.
+	 */
+	virtual void write( const record_view& record );
+
+	/**
+	 * @brief Does not block. The writer thread flushes the target after each batch.
+	 */
+	virtual void flush();
+
+	/**
+	 * @brief Block until all records queued so far were written to the target and the target is flushed
+	 */
+	virtual void drain();
+
+	virtual bool is_terminal() const { return m_target->is_terminal(); }
+
+	/**
+	 * @brief Choose what happens with records, when the ring is full
+	 * @param policy The overflow policy to use (defaults to overflow_block)
+	 * @param severity_threshold For overflow_drop_below_severity: The least critical severity that is never dropped (like logcpp::error)
+	 */
+	void set_overflow_policy( overflow_policy policy, int severity_threshold = error );
+
+	/**
+	 * @brief Set how often a summary record of dropped records is written
+	 * @param interval The minimal time between two summaries. Zero disables them.
+	 */
+	void set_drop_report_interval( std::chrono::milliseconds interval );
+
+	/**
+	 * @returns The amount of records with a specific severity dropped since construction
+	 * @param severity The severity as integer or record_view::no_severity
+	 */
+	std::size_t dropped( int severity ) const;
+
+	/**
+	 * @returns The amount of records dropped since construction
+	 */
+	std::size_t dropped_total() const;
+
+	/**
+	 * @returns The amount of records the ring can hold
+	 */
+	std::size_t depth() const { return m_mask + 1; }
+};
+
+
+} // namespace logcpp
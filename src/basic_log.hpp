@@ -30,17 +30,18 @@
 
 #include "config.hpp"
 
+#include "binary_record.hpp"
+#include "call_site.hpp"
 #include "logstream.hpp"
+#include "null_record.hpp"
+#include "timestamp.hpp"
 
 
 #include <utility>
 #include <iostream>
+#include <memory>
 #include <sstream>
 
-extern "C" {
-#include <ctime>
-}
-
 #ifdef LOGCPP_ENABLE_COLOR_SUPPORT
 #include "color_feature.hpp"
 #endif
@@ -50,10 +51,6 @@ extern "C" {
 
 namespace logcpp {
 
-/**
- * @brief A tuple containing a string and an unsigned int representing some place in a file
- */
-typedef std::pair< std::string, unsigned int > scope_t;
 /**
  * @return Free function that generates a scope_t from its parameters
  * @param place The string of the place wanted for this scope
@@ -76,20 +73,16 @@ inline scope_t scope(std::string place, unsigned int line) {
 
 /**
  * @def SCOPE
- * @brief The scope_t of the file where the macro is used. Equivalent to scope
+ * @brief The call_site of the statement where the macro is used. Logged like a scope_t, but its text is built at compile time.
  */
-#define SCOPE logcpp::scope(__FILE__, __LINE__)
+#define SCOPE LOGCPP_CALL_SITE
 
 /**
  * @returns A string with the current time like %DATE_%TIME
  */
 inline const std::string timestr() {
-	std::time_t rawtime = std::time(0);
-	struct std::tm* tinfo;
-	tinfo = std::localtime(&rawtime);
-	char buf[22];
-	std::strftime(buf, 22, "%F_%T", tinfo);
-	return std::string(buf);
+	char buf[max_timestamp_size];
+	return std::string( buf, format_timestamp( buf ) );
 }
 
 /**
@@ -124,6 +117,16 @@ public:
 		return *this;
 	}
 
+	/**
+	 * @brief Insert a severity stripped at compile time. Ends the current record and discards everything up to the next endrec.
+	 */
+	null_record operator<<(const stripped_severity&) {
+		if( !new_record ) {
+			end_record();
+		}
+		return null_record();
+	}
+
 
 protected:
 	/**
@@ -134,12 +137,27 @@ protected:
 	 * @brief Flag, if inserting the timestamp into log is enabled or not
 	 */
 	bool timestamp_enabled_;
+	/**
+	 * @brief The layout of timestamps
+	 */
+	timestamp_format time_format_;
+	/**
+	 * @brief The fraction of a second appended to timestamps
+	 */
+	timestamp_precision time_precision_;
 	/**
 	 * @brief Inserts the timestamp into log, if #timestamp_enabled_ is set to true
+	 * @note Writes the header of a binary record instead, if binary records are enabled
 	 */
 	void insert_time_or_not() {
-		if(timestamp_enabled_) {
-			stream << "[" << timestr() << "] - ";
+		if( m_binary ) {
+			m_binary->begin_record( stream, timestamp_enabled_ ? binary_flag_timestamp : 0, time_format_, time_precision_ );
+		} else if(timestamp_enabled_) {
+			char* out = stream.prepare( max_timestamp_size + 5 );
+			out[0] = '[';
+			std::size_t size = 1 + format_timestamp( out + 1, time_format_, time_precision_ );
+			std::memcpy( out + size, "] - ", 4 );
+			stream.commit( size + 4 );
 		}
 	}
 
@@ -148,6 +166,11 @@ protected:
 	 */
 	bool new_record;
 
+	/**
+	 * @brief Encodes records as binary frames, if binary records are enabled
+	 */
+	std::unique_ptr< binary_encoder > m_binary;
+
 #ifdef LOGCPP_ENABLE_COLOR_SUPPORT
 	bool m_color_ok;
 	color_feature* m_color;
@@ -169,7 +192,32 @@ public:
 	explicit basic_log( std::streambuf* outbuf = std::cout.rdbuf() )
 	    :	stream( outbuf )
 	    ,	timestamp_enabled_(false)
+	    ,	time_format_(time_default)
+	    ,	time_precision_(time_seconds)
+	    ,	new_record(true)
+	    ,	m_binary( nullptr )
+#ifdef LOGCPP_ENABLE_COLOR_SUPPORT
+	    ,	m_color_ok(false)
+	    ,	m_color( new color_feature() )
+
+	{
+		m_color_ok = stream.sink_is_terminal();
+	}
+#else
+	{}
+#endif
+
+	/**
+	 * @brief Contructor. Specify a sink to log to.
+	 * @param out A pointer to some sink where all records are written to (like a fd_sink)
+	 */
+	explicit basic_log( sink* out )
+	    :	stream( out )
+	    ,	timestamp_enabled_(false)
+	    ,	time_format_(time_default)
+	    ,	time_precision_(time_seconds)
 	    ,	new_record(true)
+	    ,	m_binary( nullptr )
 #ifdef LOGCPP_ENABLE_COLOR_SUPPORT
 	    ,	m_color_ok(false)
 	    ,	m_color( new color_feature() )
@@ -190,25 +238,48 @@ public:
 	 */
 	template< typename T >
 	void log( const termmode& mode ) {
-		if ( m_color_ok ) {
+		if ( m_color_ok && !m_binary ) {
 			stream << m_color->code(mode);
 		}
 	}
 #endif
 
     template< typename T >
-    void log( const std::string str ) {
-        stream << str.c_str();
+    void log( const std::string& str ) {
+        if( m_binary ) {
+            m_binary->argument( stream, str );
+        } else {
+            stream << str;
+        }
     }
 	
 	/**
      * @brief Flush the current buffer to output
+     * @note With binary records, this ends the current record, because a partial binary record cannot be decoded
      */
     void flush() {
+        if( m_binary && !new_record ) {
+            m_binary->end_record( stream );
+        }
         stream.flush();
         new_record = true;
     }
 
+	/**
+	 * @brief Write all further records to another sink (like an async_sink)
+	 * @param out The new sink or nullptr to write to the streambuf given on construction again
+	 */
+	void set_sink( sink* out ) {
+		stream.set_sink( out );
+	}
+
+	/**
+	 * @brief Block until all records of this logger reached their target (e.g. when an async_sink is used)
+	 */
+	void drain() {
+		stream.drain();
+	}
+
 	/**
 	 * @brief Member function that inserts a newline into the buffer, flushes it and begins a new record
 	 */
@@ -218,11 +289,38 @@ public:
 		this->log<termmode>(logcpp::ctl_reset_all);
 	}
 #endif
-	    stream << "\n";
-        
-        this->flush();
+	    if( m_binary ) {
+	        if( new_record ) {
+	            m_binary->begin_record( stream, 0, time_format_, time_precision_ );	// An empty record, like in text mode
+	        }
+	        m_binary->end_record( stream );	// A binary record carries no newline
+	        stream.flush();
+	    } else {
+	        stream.end_record();
+	    }
+	    new_record = true;
 	}
 
+	/**
+	 * @brief Write records as compact binary frames instead of text from the next record on
+	 * @note Values are formatted later by the decoder logcpp_decode (see BUILD_LOGCPP_TOOLS), which prints the same text layout.
+	 * @note Writes the frame a binary stream begins with to the sink immediately.
+	 */
+	void enable_binary_records() {
+		if( !m_binary ) {
+			m_binary.reset( new binary_encoder() );
+			m_binary->begin_stream( stream );
+		}
+	}
+	/**
+	 * @brief Write records as text again from the next record on
+	 */
+	void disable_binary_records() { m_binary.reset(); }
+	/**
+	 * @returns Wether records are written as binary frames
+	 */
+	bool binary_records_enabled() const { return static_cast< bool >( m_binary ); }
+
 	/**
 	 * @brief Enable logging the timestamp of a log record
 	 */
@@ -231,12 +329,41 @@ public:
 	 * @brief Disable logging the timestamp of a log record
 	 */
 	void disable_timestamp() { timestamp_enabled_ = false; }
+	/**
+	 * @returns Wether the timestamp of a log record is logged
+	 */
+	bool timestamp_enabled() const { return timestamp_enabled_; }
+
+	/**
+	 * @brief Set the layout of timestamps
+	 * @param format The layout (defaults to time_default like %F_%T)
+	 * @param precision The fraction of a second to append (defaults to time_seconds)
+	 */
+	void set_timestamp_format( timestamp_format format, timestamp_precision precision = time_seconds ) {
+		time_format_ = format;
+		time_precision_ = precision;
+	}
+	/**
+	 * @returns The layout of timestamps
+	 */
+	timestamp_format time_format() const { return time_format_; }
+	/**
+	 * @returns The fraction of a second appended to timestamps
+	 */
+	timestamp_precision time_precision() const { return time_precision_; }
 
 	/**
 	 * @brief Member function that inserts a newline into buffer without flushing it
 	 */
 	void end_line() {
-		stream << "\n";
+		if( m_binary ) {
+			if( new_record ) {
+				m_binary->begin_record( stream, 0, time_format_, time_precision_ );	// Like in text mode, without timestamp
+			}
+			m_binary->argument( stream, "\n" );
+		} else {
+			stream << "\n";
+		}
 		new_record = false;
 	}
 
@@ -246,8 +373,33 @@ public:
 	 */
 	template< typename T >
 	void log( const scope_t& scope) {
-		if( new_record ) insert_time_or_not();
-		stream << "[ " << scope.first << ":" << scope.second << " ] : ";
+		if( new_record ) {
+			insert_time_or_not();
+			stream.end_prefix();
+		}
+		if( m_binary ) {
+			m_binary->site( stream, scope );
+		} else {
+			stream << "[ " << scope.first << ":" << scope.second << " ] : ";
+		}
+		new_record = false;
+	}
+
+	/**
+	 * @brief Member function that logs the call_site of a statement (see SCOPE)
+	 * @param site The call_site to log
+	 */
+	template< typename T >
+	void log( const call_site& site ) {
+		if( new_record ) {
+			insert_time_or_not();
+			stream.end_prefix();
+		}
+		if( m_binary ) {
+			m_binary->site( stream, site );
+		} else {
+			stream.insert( site.text, site.text_size );
+		}
 		new_record = false;
 	}
 
@@ -257,8 +409,15 @@ public:
 	 */
 	template< typename T >
 	void log(const T& t) {
-		if( new_record ) insert_time_or_not();
-		stream << t;
+		if( new_record ) {
+			insert_time_or_not();
+			stream.end_prefix();
+		}
+		if( m_binary ) {
+			m_binary->argument( stream, t );
+		} else {
+			stream << t;
+		}
 		new_record = false;
 	}
 };
@@ -0,0 +1,108 @@
+/**
+ * @file binary_record.cpp
+ * @brief Compact binary records that are formatted to text later by logcpp_decode
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+    LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+    Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+    Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 3 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+    USA
+*/
+
+
+#include "binary_record.hpp"
+
+#include <chrono>
+#include <map>
+#include <mutex>
+
+
+namespace logcpp {
+
+std::uint32_t binary_encoder::register_site( const scope_t& scope ) {
+    static std::mutex lock;
+    static std::map< scope_t, std::uint32_t > sites;
+
+    std::lock_guard< std::mutex > guard( lock );
+    std::map< scope_t, std::uint32_t >::iterator it = sites.find( scope );
+    if ( it == sites.end() ) {
+        it = sites.insert( std::make_pair( scope, static_cast< std::uint32_t >( sites.size() + 1 ) ) ).first;
+    }
+    return it->second;
+}
+
+
+void binary_encoder::begin_stream( logstreambuf& stream ) {
+    char frame[binary_frame_header_size + sizeof( binary_magic ) + sizeof( binary_byte_order )];
+    frame[0] = static_cast< char >( binary_frame_stream );
+    std::uint32_t size = sizeof( binary_magic ) + sizeof( binary_byte_order );
+    std::memcpy( frame + 1, &size, 4 );
+    std::memcpy( frame + binary_frame_header_size, binary_magic, sizeof( binary_magic ) );
+    std::memcpy( frame + binary_frame_header_size + sizeof( binary_magic ), &binary_byte_order, sizeof( binary_byte_order ) );
+    stream.write_through( frame, sizeof( frame ) );
+}
+
+
+void binary_encoder::begin_record( logstreambuf& stream, unsigned char flags, timestamp_format format, timestamp_precision precision ) {
+    std::int64_t nanos = std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::system_clock::now().time_since_epoch() ).count();
+
+    put( stream, static_cast< char >( binary_frame_record ) );
+    put( stream, std::uint32_t( 0 ) );             // Payload size, written by end_record
+    put( stream, std::uint32_t( 0 ) );             // Site, written by site
+    put( stream, nanos );
+    put( stream, std::int32_t( record_view::no_severity ) );
+    put( stream, static_cast< char >( flags ) );
+    put( stream, static_cast< char >( format ) );
+    put( stream, static_cast< char >( precision ) );
+}
+
+
+void binary_encoder::end_record( logstreambuf& stream ) {
+    patch( stream, 1, static_cast< std::uint32_t >( stream.record_size() - binary_frame_header_size ) );
+    patch( stream, binary_frame_header_size + 12, static_cast< std::int32_t >( stream.severity() ) );
+}
+
+
+void binary_encoder::site( logstreambuf& stream, std::uint32_t id, const char* file, std::size_t file_size, unsigned int line ) {
+    if ( id >= m_defined.size() ) {
+        m_defined.resize( id + 1, false );
+    }
+    if ( !m_defined[id] ) {
+        m_defined[id] = true;
+
+        std::string frame( binary_frame_header_size + 8, '\0' );
+        frame[0] = static_cast< char >( binary_frame_site );
+        std::uint32_t size = static_cast< std::uint32_t >( 8 + file_size );
+        std::memcpy( &frame[1], &size, 4 );
+        std::memcpy( &frame[binary_frame_header_size], &id, 4 );
+        std::memcpy( &frame[binary_frame_header_size + 4], &line, 4 );
+        frame.append( file, file_size );
+        stream.write_through( frame.data(), frame.size() );
+    }
+
+    std::uint32_t first = 0;
+    std::memcpy( &first, stream.record_data() + binary_frame_header_size, 4 );
+    if ( first == 0 ) {
+        patch( stream, binary_frame_header_size, id );
+    }
+    put( stream, static_cast< char >( binary_site ) );
+    put( stream, id );
+}
+
+
+} // namespace logcpp
@@ -0,0 +1,257 @@
+/**
+ * @file binary_record.hpp
+ * @brief Compact binary records that are formatted to text later by logcpp_decode
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+	LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+	Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+	Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+	USA
+*/
+
+
+
+#pragma once
+
+#include "config.hpp"
+
+#include "call_site.hpp"
+#include "logstream.hpp"
+#include "timestamp.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace logcpp {
+
+/**
+ * @brief The frames a binary log stream consists of. Each frame is a type byte followed by the size of its payload as 32 bit integer.
+ */
+enum binary_frame {
+	/**
+	 * @brief Begins a binary stream. Payload: binary_magic and binary_byte_order.
+	 */
+	binary_frame_stream = 'H',
+	/**
+	 * @brief Defines a call site. Payload: 32 bit id, 32 bit line and the file name.
+	 */
+	binary_frame_site = 'S',
+	/**
+	 * @brief A record. Payload: 32 bit site id, 64 bit nanoseconds since the epoch, 32 bit severity,
+	 * @brief flags, timestamp_format and timestamp_precision as bytes, followed by the arguments.
+	 */
+	binary_frame_record = 'R'
+};
+
+
+/**
+ * @brief The type byte in front of each argument of a binary record
+ */
+enum binary_argument {
+	binary_int = 'i',	///< 64 bit signed integer
+	binary_uint = 'u',	///< 64 bit unsigned integer
+	binary_double = 'd',	///< 64 bit floating point number
+	binary_bool = 'b',	///< One byte
+	binary_char = 'c',	///< One byte
+	binary_text = 's',	///< 32 bit length and the bytes of a string or of a value formatted as text
+	binary_site = 'p'	///< 32 bit id of a call site inserted with SCOPE
+};
+
+
+/**
+ * @brief Flags stored with each binary record
+ */
+enum binary_record_flags {
+	binary_flag_timestamp = 1,	///< The logger had timestamps enabled
+	binary_flag_severity = 2	///< The logger printed the severity name
+};
+
+
+/**
+ * @brief The bytes a binary stream begins with
+ */
+const char binary_magic[8] = { 'L', 'O', 'G', 'C', 'P', 'P', 'B', '1' };
+
+/**
+ * @brief Written in native byte order after binary_magic, so a decoder can detect a different byte order
+ */
+const std::uint32_t binary_byte_order = 0x01020304;
+
+/**
+ * @brief The size of the type and size fields in front of each frame
+ */
+const std::size_t binary_frame_header_size = 5;
+
+/**
+ * @brief The size of the fixed part of a record payload
+ */
+const std::size_t binary_record_header_size = 4 + 8 + 4 + 3;
+
+
+/**
+ * @brief Writes records as binary frames into the record buffer of a logger
+ * @note Numbers are stored as raw bytes. Values are only formatted as text on the logging thread,
+ * @note if they have no binary representation or the stream has manipulators set (like std::hex).
+ */
+class binary_encoder
+{
+protected:
+	/**
+	 * @brief Wether this encoder wrote the definition of a call site, indexed by its id
+	 */
+	std::vector< bool > m_defined;
+
+	template< typename T >
+	static void put( logstreambuf& stream, const T& value ) {
+		char* out = stream.prepare( sizeof( T ) );
+		std::memcpy( out, &value, sizeof( T ) );
+		stream.commit( sizeof( T ) );
+	}
+
+	template< typename T >
+	static void patch( logstreambuf& stream, std::size_t offset, const T& value ) {
+		std::memcpy( stream.record_data() + offset, &value, sizeof( T ) );
+	}
+
+	/**
+	 * @returns Wether numbers can be stored as raw bytes, because no manipulator changed their text layout
+	 */
+	static bool plain( const logstreambuf& stream ) {
+		return ( stream.flags() == ( std::ios_base::dec | std::ios_base::skipws )
+		      && stream.width() == 0
+		      && stream.precision() == 6 );
+	}
+
+	/**
+	 * @brief Write a value as binary_text formatted by the stream
+	 */
+	template< typename T >
+	static void text( logstreambuf& stream, const T& t ) {
+		put( stream, static_cast< char >( binary_text ) );
+		std::size_t length_offset = stream.record_size();
+		put( stream, std::uint32_t( 0 ) );
+		stream << t;
+		patch( stream, length_offset, static_cast< std::uint32_t >( stream.record_size() - length_offset - 4 ) );
+	}
+
+	/**
+	 * @returns The process-wide id of a call site
+	 */
+	static std::uint32_t register_site( const scope_t& scope );
+
+	/**
+	 * @brief Insert a call site by its id. Its definition is written to the sink first, if this encoder did not write it before.
+	 */
+	void site( logstreambuf& stream, std::uint32_t id, const char* file, std::size_t file_size, unsigned int line );
+
+public:
+	/**
+	 * @brief Write the frame a binary stream begins with directly to the sink of stream
+	 */
+	void begin_stream( logstreambuf& stream );
+
+	/**
+	 * @brief Write the header of a record with the current time into the empty record buffer
+	 * @param flags Some binary_record_flags
+	 * @param format The layout of the timestamp when decoded
+	 * @param precision The fraction of a second of the timestamp when decoded
+	 */
+	void begin_record( logstreambuf& stream, unsigned char flags, timestamp_format format, timestamp_precision precision );
+
+	/**
+	 * @brief Set a flag in the header of the current record
+	 * @param flag Some binary_record_flags
+	 */
+	void set_flag( logstreambuf& stream, unsigned char flag ) {
+		stream.record_data()[binary_frame_header_size + 16] |= static_cast< char >( flag );
+	}
+
+	/**
+	 * @brief Write the size and severity of the current record into its header
+	 */
+	void end_record( logstreambuf& stream );
+
+	/**
+	 * @brief Insert a call site. Its definition is written to the sink first, if this encoder did not write it before.
+	 * @param scope The file and line of the site
+	 */
+	void site( logstreambuf& stream, const scope_t& scope ) {
+		site( stream, register_site( scope ), scope.first.data(), scope.first.size(), scope.second );
+	}
+
+	/**
+	 * @brief Insert the call_site of a statement (see SCOPE). Its id is looked up once and kept in the call_site.
+	 */
+	void site( logstreambuf& stream, const call_site& site ) {
+		std::uint32_t id = site.binary_id.load( std::memory_order_relaxed );
+		if ( id == 0 ) {
+			id = register_site( site );
+			const_cast< call_site& >( site ).binary_id.store( id, std::memory_order_relaxed );
+		}
+		this->site( stream, id, site.file, site.file_size, site.line );
+	}
+
+	/**
+	 * @brief Insert some argument
+	 * @param t Some object. Numbers are stored as raw bytes, all other objects as text.
+	 */
+	template< typename T >
+	void argument( logstreambuf& stream, const T& t ) {
+		if constexpr ( std::is_same< T, bool >::value ) {
+			if ( plain( stream ) ) {
+				put( stream, static_cast< char >( binary_bool ) );
+				put( stream, static_cast< char >( t ? 1 : 0 ) );
+				return;
+			}
+		} else if constexpr ( std::is_same< T, char >::value || std::is_same< T, signed char >::value || std::is_same< T, unsigned char >::value ) {
+			if ( stream.width() == 0 ) {
+				put( stream, static_cast< char >( binary_char ) );
+				put( stream, static_cast< char >( t ) );
+				return;
+			}
+		} else if constexpr ( std::is_integral< T >::value
+		                   && !std::is_same< T, wchar_t >::value && !std::is_same< T, char16_t >::value && !std::is_same< T, char32_t >::value ) {
+			if constexpr ( sizeof( T ) <= 8 ) {	// Only checked for integers, manipulators like std::hex are functions
+				if ( plain( stream ) ) {
+					if constexpr ( std::is_signed< T >::value ) {
+						put( stream, static_cast< char >( binary_int ) );
+						put( stream, static_cast< std::int64_t >( t ) );
+					} else {
+						put( stream, static_cast< char >( binary_uint ) );
+						put( stream, static_cast< std::uint64_t >( t ) );
+					}
+					return;
+				}
+			}
+		} else if constexpr ( std::is_floating_point< T >::value ) {
+			if ( plain( stream ) ) {
+				put( stream, static_cast< char >( binary_double ) );
+				put( stream, static_cast< double >( t ) );
+				return;
+			}
+		}
+		text( stream, t );
+	}
+};
+
+} // namespace logcpp
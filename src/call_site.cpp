@@ -0,0 +1,107 @@
+/**
+ * @file call_site.cpp
+ * @brief The registry of all call sites
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+    LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+    Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+    Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 3 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+    USA
+*/
+
+
+
+#include "call_site.hpp"
+
+#include <cstring>
+#include <mutex>
+
+
+namespace logcpp {
+
+namespace {
+
+/**
+ * @brief The registered sites. Constructed on first use, because sites register during the static initialization.
+ */
+struct registry_storage {
+    std::mutex lock;
+    std::vector< call_site* > sites;
+};
+
+registry_storage& storage() {
+    static registry_storage instance;
+    return instance;
+}
+
+} // namespace
+
+
+void site_registry::add( call_site& site ) {
+    registry_storage& registry = storage();
+    std::lock_guard< std::mutex > guard( registry.lock );
+    if ( site.id != 0 ) {
+        return;
+    }
+    registry.sites.push_back( &site );
+    site.id = static_cast< std::uint32_t >( registry.sites.size() );
+}
+
+
+std::vector< call_site* > site_registry::sites() {
+    registry_storage& registry = storage();
+    std::lock_guard< std::mutex > guard( registry.lock );
+    return registry.sites;
+}
+
+
+call_site* site_registry::find( std::uint32_t id ) {
+    registry_storage& registry = storage();
+    std::lock_guard< std::mutex > guard( registry.lock );
+    if ( id == 0 || id > registry.sites.size() ) {
+        return nullptr;
+    }
+    return registry.sites[id - 1];
+}
+
+
+std::size_t site_registry::enable( const std::string& file, unsigned int line, bool enable ) {
+    registry_storage& registry = storage();
+    std::lock_guard< std::mutex > guard( registry.lock );
+    std::size_t matched = 0;
+    for ( std::size_t i = 0; i < registry.sites.size(); i++ ) {
+        call_site* site = registry.sites[i];
+        if ( site->file_size == file.size() && std::memcmp( site->file, file.data(), file.size() ) == 0
+          && ( line == 0 || site->line == line ) ) {
+            site->enabled.store( enable, std::memory_order_relaxed );
+            matched++;
+        }
+    }
+    return matched;
+}
+
+
+void site_registry::enable_all( bool enable ) {
+    registry_storage& registry = storage();
+    std::lock_guard< std::mutex > guard( registry.lock );
+    for ( std::size_t i = 0; i < registry.sites.size(); i++ ) {
+        registry.sites[i]->enabled.store( enable, std::memory_order_relaxed );
+    }
+}
+
+} // namespace logcpp
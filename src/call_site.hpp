@@ -0,0 +1,314 @@
+/**
+ * @file call_site.hpp
+ * @brief Call sites of log statements with their text computed at compile time
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+	LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+	Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+	Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+	USA
+*/
+
+
+
+
+#pragma once
+
+#include "config.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace logcpp {
+
+/**
+ * @brief A tuple containing a string and an unsigned int representing some place in a file
+ */
+typedef std::pair< std::string, unsigned int > scope_t;
+
+
+/**
+ * @returns The offset of the file name behind the directories of path (unless LOGCPP_LEAVE_SCOPE_DIRS_PREFIX is defined)
+ */
+constexpr std::size_t basename_offset( const char* path ) {
+	std::size_t offset = 0;
+#ifndef LOGCPP_LEAVE_SCOPE_DIRS_PREFIX
+	for ( std::size_t i = 1; path[i] != '\0'; i++ ) {	// A separator at the beginning is kept, like logcpp::scope does
+#ifdef _WIN32
+		if ( path[i] == '\\' ) {
+#else
+		if ( path[i] == '/' ) {
+#endif
+			offset = i + 1;
+		}
+	}
+#endif
+	return offset;
+}
+
+/**
+ * @returns The amount of characters of a null-terminated string
+ */
+constexpr std::size_t string_length( const char* text ) {
+	std::size_t length = 0;
+	while ( text[length] != '\0' ) {
+		length++;
+	}
+	return length;
+}
+
+/**
+ * @returns The amount of decimal digits of number
+ */
+constexpr std::size_t decimal_digits( unsigned int number ) {
+	std::size_t digits = 1;
+	while ( number >= 10 ) {
+		number /= 10;
+		digits++;
+	}
+	return digits;
+}
+
+/**
+ * @returns The text a call site is logged as, like "[ file:line ] : "
+ */
+template< std::size_t size >
+constexpr std::array< char, size > site_text( const char* file, std::size_t file_size, unsigned int line ) {
+	std::array< char, size > text = {};
+	std::size_t pos = 0;
+	text[pos++] = '[';
+	text[pos++] = ' ';
+	for ( std::size_t i = 0; i < file_size; i++ ) {
+		text[pos++] = file[i];
+	}
+	text[pos++] = ':';
+	std::size_t digits = decimal_digits( line );
+	for ( std::size_t i = 0; i < digits; i++ ) {
+		text[pos + digits - 1 - i] = static_cast< char >( '0' + line % 10 );
+		line /= 10;
+	}
+	pos += digits;
+	text[pos++] = ' ';
+	text[pos++] = ']';
+	text[pos++] = ' ';
+	text[pos++] = ':';
+	text[pos] = ' ';
+	return text;
+}
+
+
+/**
+ * @brief The place of a log statement. Exists once per statement in static storage and is constant initialized.
+ * @note Each call_site is added to the site_registry at startup and can be switched off there while the program runs.
+ */
+struct call_site {
+	/**
+	 * @brief The severity of a site that has none or whose statement did not run yet
+	 */
+	static const int no_severity = -1;
+
+	/**
+	 * @brief The file name without directories
+	 */
+	const char* file;
+	std::size_t file_size;
+	unsigned int line;
+	/**
+	 * @brief The name of the function, known after the statement ran once
+	 */
+	std::atomic< const char* > function;
+	/**
+	 * @brief The severity inserted with the site by SCOPE_SEVERITY, known after the statement ran once
+	 */
+	std::atomic< int > severity;
+	/**
+	 * @brief Wether records containing this site are written. Checked with one relaxed load when the site is inserted.
+	 */
+	std::atomic< bool > enabled;
+	/**
+	 * @brief The id in the site_registry, starting at 1. Assigned at startup.
+	 */
+	std::uint32_t id;
+	/**
+	 * @brief The site as logged, like "[ file:line ] : "
+	 */
+	const char* text;
+	std::size_t text_size;
+	/**
+	 * @brief The id of the site in binary records or 0, if it has none yet
+	 */
+	std::atomic< std::uint32_t > binary_id;
+
+	constexpr call_site( const char* file, std::size_t file_size, unsigned int line, const char* text, std::size_t text_size )
+		:	file( file )
+		,	file_size( file_size )
+		,	line( line )
+		,	function( nullptr )
+		,	severity( no_severity )
+		,	enabled( true )
+		,	id( 0 )
+		,	text( text )
+		,	text_size( text_size )
+		,	binary_id( 0 )
+	{}
+	call_site( const call_site& ) = delete;
+
+	/**
+	 * @returns Wether records containing this site are written
+	 */
+	bool is_enabled() const {
+		return enabled.load( std::memory_order_relaxed );
+	}
+
+	/**
+	 * @returns The site as scope_t (like logcpp::scope returns it)
+	 */
+	operator scope_t() const {
+		return scope_t( std::string( file, file_size ), line );
+	}
+};
+
+
+/**
+ * @brief All call sites of the program (and of loaded libraries), e.g. to list them or switch noisy ones off while running
+ */
+class site_registry
+{
+public:
+	/**
+	 * @brief Add a call site and assign its id. Called for each site at startup.
+	 */
+	static void add( call_site& site );
+
+	/**
+	 * @returns All call sites registered so far, ordered by id
+	 */
+	static std::vector< call_site* > sites();
+
+	/**
+	 * @returns The call site with an id or nullptr
+	 */
+	static call_site* find( std::uint32_t id );
+
+	/**
+	 * @brief Switch all sites in a file on or off. Records that contain a site that is off are dropped like filtered records.
+	 * @param file The file name without directories (like main.cpp)
+	 * @param line The line of the site or 0 for all sites in file
+	 * @param enable Wether the sites are switched on or off
+	 * @returns The amount of sites that matched
+	 */
+	static std::size_t enable( const std::string& file, unsigned int line = 0, bool enable = true );
+
+	/**
+	 * @brief Switch all sites on or off
+	 */
+	static void enable_all( bool enable = true );
+};
+
+
+/**
+ * @brief Adds a call site to the site_registry when it is constructed
+ */
+struct site_registration {
+	explicit site_registration( call_site& site ) {
+		site_registry::add( site );
+	}
+};
+
+
+/**
+ * @brief The call site of a log statement. tag_t is a type local to the statement, see LOGCPP_CALL_SITE.
+ */
+template< typename tag_t >
+struct call_site_of {
+	static constexpr std::size_t offset = basename_offset( tag_t::file() );
+	static constexpr std::size_t file_size = string_length( tag_t::file() ) - offset;
+	static constexpr std::size_t text_size = 2 + file_size + 1 + decimal_digits( tag_t::line() ) + 5;
+	static constexpr std::array< char, text_size > text = site_text< text_size >( tag_t::file() + offset, file_size, tag_t::line() );
+
+	static inline call_site site = call_site( tag_t::file() + offset, file_size, tag_t::line(), text.data(), text_size );
+	/**
+	 * @brief Adds site to the site_registry during the dynamic initialization at startup
+	 */
+	static inline site_registration registration = site_registration( site );
+
+	/**
+	 * @returns The call site
+	 * @param function The name of the function the statement is in
+	 */
+	static const call_site& get( const char* function ) {
+		(void)&registration;	// Instantiates the registration
+		if ( site.function.load( std::memory_order_relaxed ) == nullptr ) {
+			site.function.store( function, std::memory_order_relaxed );
+		}
+		return site;
+	}
+
+	/**
+	 * @returns The call site, after noting the severity it is inserted with
+	 * @param function The name of the function the statement is in
+	 * @param severity The severity as integer
+	 */
+	static const call_site& get( const char* function, int severity ) {
+		if ( site.severity.load( std::memory_order_relaxed ) != severity ) {
+			site.severity.store( severity, std::memory_order_relaxed );
+		}
+		return get( function );
+	}
+};
+
+} // namespace logcpp
+
+
+/**
+ * @def LOGCPP_CALL_SITE_SEVERITY_IN(lvl_, function_)
+ * @brief Like LOGCPP_CALL_SITE_SEVERITY with the name of the function given, for sites built inside a lambda (where __func__ is "operator()")
+ */
+#define LOGCPP_CALL_SITE_SEVERITY_IN(lvl_, function_) \
+	[]( const char* logcpp_site_function_, int logcpp_site_severity_ ) -> const logcpp::call_site& { \
+		struct logcpp_site_tag { \
+			static constexpr const char* file() { return __FILE__; } \
+			static constexpr unsigned int line() { return __LINE__; } \
+		}; \
+		return logcpp::call_site_of< logcpp_site_tag >::get( logcpp_site_function_, logcpp_site_severity_ ); \
+	}( function_, static_cast< int >( lvl_ ) )
+
+/**
+ * @def LOGCPP_CALL_SITE_SEVERITY(lvl_)
+ * @brief Like LOGCPP_CALL_SITE for a site that is inserted with the severity lvl_
+ */
+#define LOGCPP_CALL_SITE_SEVERITY(lvl_) LOGCPP_CALL_SITE_SEVERITY_IN(lvl_, __func__)
+
+/**
+ * @def LOGCPP_CALL_SITE
+ * @brief A reference to the call_site of the statement it is used in. File name and text are computed at compile time.
+ */
+#define LOGCPP_CALL_SITE \
+	[]( const char* function_ ) -> const logcpp::call_site& { \
+		struct logcpp_site_tag { \
+			static constexpr const char* file() { return __FILE__; } \
+			static constexpr unsigned int line() { return __LINE__; } \
+		}; \
+		return logcpp::call_site_of< logcpp_site_tag >::get( function_ ); \
+	}( __func__ )
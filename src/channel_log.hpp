@@ -28,29 +28,109 @@
 
 #include "basic_log.hpp"
 
-#include <map>
-#include <set>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace logcpp {
 
+/**
+ * @brief The handle of a channel of a channel_log. Channels are numbered in the order they are added.
+ */
+typedef std::size_t channel_handle;
+
+/**
+ * @brief The handle returned for names that are no channel
+ */
+const channel_handle no_channel = static_cast< channel_handle >( -1 );
+
+
+/**
+ * @brief Wether a broadcast object is handed to each channel as it is instead of being formatted once for all
+ * @note Severities (enums), severities with a scope (pairs, see SCOPE_SEVERITY), call sites (SCOPE) and stripped severities
+ * @note are record tags, which start or end a record in each channel with its own prefix and filters
+ */
+template< typename T >
+struct channel_forwarded
+	:	public std::is_enum< T >
+{};
+
+template< typename first_t, typename second_t >
+struct channel_forwarded< std::pair< first_t, second_t > >
+	:	public std::true_type
+{};
+
+template<>
+struct channel_forwarded< call_site >
+	:	public std::true_type
+{};
+
+template<>
+struct channel_forwarded< stripped_severity >
+	:	public std::true_type
+{};
+
+
 /**
  * @brief A logger with different channels of type logger_t
  */
 template< class logger_t >
 class channel_log {
 protected:
-	basic_log* m_default_channel;
-	std::map< const std::string, logger_t* > m_channels;
-	std::set< std::string > m_channels_enabled;
+	std::unique_ptr< logger_t > m_default_channel;
+	std::vector< logger_t* > m_channels;
+	std::unordered_map< std::string, channel_handle > m_handles;
+	/**
+	 * @brief One bit per channel handle that is set, if the channel is enabled
+	 */
+	std::vector< std::uint64_t > m_enabled;
+	/**
+	 * @brief The body of a broadcast record, formatted once and handed to all enabled channels
+	 */
+	logstreambuf m_broadcast;
+
+	/**
+	 * @brief Call f with each enabled channel
+	 */
+	template< typename function_t >
+	void for_each_enabled( function_t f ) {
+		for ( std::size_t word = 0; word < m_enabled.size(); word++ ) {
+			std::size_t handle = word * 64;
+			for ( std::uint64_t bits = m_enabled[word]; bits != 0; bits >>= 1, handle++ ) {
+				if ( bits & 1 ) {
+					f( *m_channels[handle] );
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Hand the broadcast content formatted so far to all enabled channels
+	 */
+	void fan_out() {
+		if ( !m_broadcast.has_buffered_content() ) {
+			return;
+		}
+		const std::string_view body( m_broadcast.record_data(), m_broadcast.record_size() );
+		for_each_enabled( [&body]( logger_t& channel ) { channel << body; } );
+		m_broadcast.clear_buf();
+	}
 
 public:
 	/**
 	 * @brief Constructor.
 	 */
 	channel_log()
-		:	m_default_channel( new basic_log() )
+		:	m_default_channel()
 		,	m_channels()
-		,	m_channels_enabled()
+		,	m_handles()
+		,	m_enabled()
+		,	m_broadcast( static_cast< std::streambuf* >( nullptr ) )	// Never flushed, only read by fan_out
 	{}
 
 	/**
@@ -63,9 +143,27 @@ public:
 	 * @param channel_name Name of the new channel
 	 * @param logger The logger that is to be added with that name
 	 * @returns Wether the logger was added or not
+	 * @note The channel gets the next handle, see channel
+	 */
+	bool add_channel( const std::string& channel_name, logger_t& logger ) {
+		if ( !m_handles.emplace( channel_name, m_channels.size() ).second ) {
+			return false;
+		}
+		m_channels.push_back( &logger );
+		if ( m_enabled.size() * 64 < m_channels.size() ) {
+			m_enabled.push_back( 0 );
+		}
+		return true;
+	}
+
+	/**
+	 * @returns The handle of a channel for the functions and operators below that take handles or no_channel
+	 * @param channel_name Name of the channel to find
+	 * @note Look a channel up once and use its handle on hot paths
 	 */
-	bool add_channel( const std::string channel_name, logger_t& logger ) {
-		return m_channels.insert( std::make_pair(channel_name, &logger) ).second;
+	channel_handle channel( const std::string& channel_name ) const {
+		typename std::unordered_map< std::string, channel_handle >::const_iterator it = m_handles.find( channel_name );
+		return it != m_handles.cend() ? it->second : no_channel;
 	}
 	
 	/**
@@ -73,87 +171,120 @@ public:
 	 * @param channel_name Name of the channel to find
 	 * @returns Wether the channel was found.
 	 */
-	bool channel_exists( const std::string channel_name ) {
-		bool found = false;
-		for ( typename std::map< const std::string, logger_t* >::const_iterator it = m_channels.cbegin()
-			; it != m_channels.cend()
-			; it++
-		) {
-			if ( channel_name.compare(it->first) == 0 ) {
-				found = true;
-				break;
-			}
-		}
-		return found;
+	bool channel_exists( const std::string& channel_name ) const {
+		return m_handles.count( channel_name ) != 0;
 	}
 	
 	/**
-	 * @brief Enables a channel with a given name, if found
-	 * @param channel_name Name of the channel to enable
+	 * @brief Enables a channel with a given handle, if it exists
+	 * @param handle Handle of the channel to enable
 	 * @returns Wether the channel is enabled. Returns false, if the channel is not found.
 	 */
-	bool enable_channel( const std::string channel_name ) {
-		if ( !this->channel_exists(channel_name) ) {
+	bool enable_channel( channel_handle handle ) {
+		if ( handle >= m_channels.size() ) {
 			return false;
 		}
-		
-		m_channels_enabled.insert( channel_name );
+		m_enabled[handle / 64] |= std::uint64_t( 1 ) << ( handle % 64 );
 		return true;
 	}
+
+	/**
+	 * @brief Enables a channel with a given name, if found
+	 * @param channel_name Name of the channel to enable
+	 * @returns Wether the channel is enabled. Returns false, if the channel is not found.
+	 */
+	bool enable_channel( const std::string& channel_name ) {
+		return this->enable_channel( this->channel( channel_name ) );
+	}
 	
+	/**
+	 * @brief Disables a channel with a given handle, if it exists
+	 * @param handle Handle of the channel to disable
+	 */
+	bool disable_channel( channel_handle handle ) {
+		if ( handle < m_channels.size() ) {
+			m_enabled[handle / 64] &= ~( std::uint64_t( 1 ) << ( handle % 64 ) );
+		}
+		return true;
+	}
+
 	/**
 	 * @brief Disables a channel with a given name, if found
 	 * @param channel_name Name of the channel to disable
 	 */
-	bool disable_channel( const std::string channel_name ) {
-		m_channels_enabled.erase( channel_name );
-		return true;
+	bool disable_channel( const std::string& channel_name ) {
+		return this->disable_channel( this->channel( channel_name ) );
+	}
+
+	/**
+	 * @returns Wether a channel is enabled
+	 * @param handle Handle of the channel
+	 */
+	bool channel_enabled( channel_handle handle ) const {
+		return handle < m_channels.size() && ( m_enabled[handle / 64] >> ( handle % 64 ) & 1 ) != 0;
+	}
+
+	/**
+	 * @brief This operator is used to access the channels by their handle.
+	 * @param handle The handle of the channel to log to (see channel)
+	 * @returns A reference to the logger found or a default logger
+	 * @note If no channel has this handle, everything is logged to a default logger_t (on std::cout for the loggers of this library)
+	 */
+	logger_t& operator[] ( channel_handle handle ) {
+		if ( handle < m_channels.size() ) {
+			return *m_channels[handle];
+		}
+		if ( !m_default_channel ) {
+			m_default_channel.reset( new logger_t() );
+		}
+		return *m_default_channel;
 	}
 
 	/**
 	 * @brief This operator is used to access the channels by their name.
 	 * @param channel_name The name of the channel to log to
-	 * @returns A reference to the logger found or a default basic_log
-	 * @note If no channel is found with this name, everything is logged to a basic_log on std::cout, no matter, if function are understood or not.
+	 * @returns A reference to the logger found or a default logger
+	 * @note If no channel is found with this name, everything is logged to a default logger_t (on std::cout for the loggers of this library)
 	 * @note Be careful not to have typos...
 	 */
-	logger_t& operator[] ( const std::string channel_name ) {
-		try {
-			logger_t* logger = m_channels.at( channel_name );
-			return *logger;
-		} catch ( std::out_of_range& oor ) {
-			return *m_default_channel;
-		}
+	logger_t& operator[] ( const std::string& channel_name ) {
+		return this->operator[]( this->channel( channel_name ) );
 	}
 	
 	/**
 	 * @brief This operator is used to insert streams in all channels that are enabled
 	 * @param t Content to log to all channels enabled at once
 	 * @returns A reference to this
+	 * @note Content is formatted once and handed to the channels, when a function (like logcpp::endrec) or a severity is inserted
 	 */
 	template< typename T >
 	channel_log<logger_t>& operator<< ( const T& t ) {
-		for ( typename std::set< std::string >::const_iterator it = m_channels_enabled.cbegin()
-			; it != m_channels_enabled.cend()
-			; it++
-		) {
-			this->operator[](*it) << t;
+		if constexpr ( channel_forwarded< T >::value ) {
+			this->fan_out();
+			for_each_enabled( [&t]( logger_t& channel ) { channel << t; } );
+		} else {
+			m_broadcast << t;
 		}
 		return *this;
 	}
 	
+	/**
+	 * @brief Insert a severity stripped at compile time into all channels that are enabled
+	 * @returns A null_record that discards everything up to the next endrec
+	 */
+	null_record operator<< ( const stripped_severity& stripped ) {
+		this->operator<< < stripped_severity >( stripped );
+		return null_record();
+	}
+
 	/**
 	 * @brief This operator is used to insert functions in all channels that are enabled
 	 * @param f Function to insert
 	 * @returns A reference to this
 	 */
 	channel_log<logger_t>& operator<< ( logger_t& f(logger_t&) ) {
-		for ( typename std::set< std::string >::const_iterator it = m_channels_enabled.cbegin()
-			; it != m_channels_enabled.cend()
-			; it++
-		) {
-			this->operator[](*it) << f;
-		}
+		this->fan_out();
+		for_each_enabled( [f]( logger_t& channel ) { channel << f; } );
 		return *this;
 	}
 };
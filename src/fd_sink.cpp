@@ -0,0 +1,161 @@
+/**
+ * @file fd_sink.cpp
+ * @brief A sink that writes to a POSIX file descriptor without std::ostream in between
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+    LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+    Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+    Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 3 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+    USA
+*/
+
+
+#include "fd_sink.hpp"
+
+#ifdef __unix__
+
+#include <cerrno>
+#include <cstring>
+
+extern "C" {
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+}
+
+
+namespace logcpp {
+
+fd_sink::fd_sink( int fd, bool take_ownership, std::size_t buffer_size )
+    :   m_fd( fd )
+    ,   m_owns_fd( take_ownership )
+    ,   m_terminal( fd >= 0 && ::isatty( fd ) == 1 )
+    ,   m_buffer( new char[buffer_size] )
+    ,   m_capacity( buffer_size )
+    ,   m_used( 0 )
+{}
+
+
+fd_sink::fd_sink( const std::string& path, std::size_t buffer_size )
+    :   m_fd( ::open( path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644 ) )
+    ,   m_owns_fd( true )
+    ,   m_terminal( m_fd >= 0 && ::isatty( m_fd ) == 1 )
+    ,   m_buffer( new char[buffer_size] )
+    ,   m_capacity( buffer_size )
+    ,   m_used( 0 )
+{}
+
+
+fd_sink::~fd_sink() {
+    flush();
+    if ( m_owns_fd && m_fd >= 0 ) {
+        ::close( m_fd );
+    }
+    delete[] m_buffer;
+}
+
+
+void fd_sink::write_out( const void* pieces, int count ) {
+    struct iovec iov[8];
+    int iovcnt = 0;
+
+    if ( m_used > 0 ) {
+        iov[iovcnt].iov_base = m_buffer;
+        iov[iovcnt].iov_len = m_used;
+        iovcnt++;
+    }
+    const struct iovec* more = static_cast< const struct iovec* >( pieces );
+    for ( int i = 0; i < count && iovcnt < 8; i++ ) {
+        if ( more[i].iov_len > 0 ) {
+            iov[iovcnt++] = more[i];
+        }
+    }
+    m_used = 0;
+
+    struct iovec* current = iov;
+    while ( iovcnt > 0 && m_fd >= 0 ) {
+        ssize_t written = ::writev( m_fd, current, iovcnt );
+        if ( written < 0 ) {
+            if ( errno == EINTR ) {
+                continue;
+            }
+            return; // Logging must not fail the application, so the data is dropped
+        }
+        std::size_t done = static_cast< std::size_t >( written );
+        while ( iovcnt > 0 && done >= current->iov_len ) {
+            done -= current->iov_len;
+            current++;
+            iovcnt--;
+        }
+        if ( iovcnt > 0 ) {
+            current->iov_base = static_cast< char* >( current->iov_base ) + done;
+            current->iov_len -= done;
+        }
+    }
+}
+
+
+void fd_sink::write( const record_view& record ) {
+    std::size_t total = record.prefix_size + record.body_size + ( record.terminated ? 1 : 0 );
+
+    if ( m_used + total <= m_capacity ) {
+        std::memcpy( m_buffer + m_used, record.prefix, record.prefix_size );
+        m_used += record.prefix_size;
+        std::memcpy( m_buffer + m_used, record.body, record.body_size );
+        m_used += record.body_size;
+        if ( record.terminated ) {
+            m_buffer[m_used++] = '\n';
+        }
+        return;
+    }
+
+    static char newline = '\n';
+    struct iovec pieces[3];
+    pieces[0].iov_base = const_cast< char* >( record.prefix );
+    pieces[0].iov_len = record.prefix_size;
+    pieces[1].iov_base = const_cast< char* >( record.body );
+    pieces[1].iov_len = record.body_size;
+    pieces[2].iov_base = &newline;
+    pieces[2].iov_len = record.terminated ? 1 : 0;
+    write_out( pieces, 3 );
+}
+
+
+void fd_sink::flush() {
+    if ( m_used > 0 ) {
+        write_out( nullptr, 0 );
+    }
+}
+
+
+void fd_sink::sync() {
+    flush();
+    if ( m_fd < 0 ) {
+        return;
+    }
+#ifdef __linux__
+    while ( ::fdatasync( m_fd ) != 0 && errno == EINTR ) {}
+#else
+    while ( ::fsync( m_fd ) != 0 && errno == EINTR ) {}
+#endif
+}
+
+
+} // namespace logcpp
+
+#endif
@@ -0,0 +1,121 @@
+/**
+ * @file fd_sink.hpp
+ * @brief A sink that writes to a POSIX file descriptor without std::ostream in between
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+	LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+	Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+	Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+	USA
+*/
+
+
+#pragma once
+
+#include "config.hpp"
+
+#ifdef __unix__
+
+#include "sink.hpp"
+
+#include <string>
+
+
+namespace logcpp {
+
+/**
+ * @brief A sink owning a buffer that is written to a file descriptor with writev
+ * @note Records that fit into the buffer are copied into it. Otherwise the buffer, prefix, body
+ * @note and newline of a record are submitted with a single writev instead of being concatenated.
+ */
+class fd_sink
+	:	public sink
+{
+public:
+	/**
+	 * @brief The default size of the buffer of a fd_sink
+	 */
+	static const std::size_t default_buffer_size = 64 * 1024;
+
+protected:
+	int m_fd;
+	bool m_owns_fd;
+	bool m_terminal;
+	char* m_buffer;
+	std::size_t m_capacity;
+	std::size_t m_used;
+
+	/**
+	 * @brief Write the buffer and count further pieces to the file descriptor
+	 * @param pieces Pointer to an array of struct iovec following the buffer
+	 * @param count The amount of pieces
+	 */
+	void write_out( const void* pieces, int count );
+
+public:
+	/**
+	 * @brief Creates a sink writing to an open file descriptor (like STDOUT_FILENO)
+	 * @param fd The file descriptor to write to
+	 * @param take_ownership Wether the file descriptor is closed, when the sink is destroyed
+	 * @param buffer_size The amount of bytes buffered before writing
+	 */
+	explicit fd_sink( int fd, bool take_ownership = false, std::size_t buffer_size = default_buffer_size );
+
+	/**
+	 * @brief Creates a sink appending to a file, which is created if it does not exist
+	 * @param path The path of the file to append to
+	 * @param buffer_size The amount of bytes buffered before writing
+	 */
+	explicit fd_sink( const std::string& path, std::size_t buffer_size = default_buffer_size );
+
+	fd_sink( const fd_sink& ) = delete;
+
+	/**
+	 * @brief Destructor. Flushes the buffer and closes the file descriptor, if owned.
+	 */
+	virtual ~fd_sink();
+
+	/**
+	 * @returns Wether the sink has a valid file descriptor
+	 */
+	bool is_open() const { return m_fd >= 0; }
+
+	/**
+	 * @returns The file descriptor this sink writes to
+	 */
+	int fd() const { return m_fd; }
+
+	virtual void write( const record_view& record );
+
+	virtual void flush();
+
+	/**
+	 * @brief Flush and wait until the written data reached the storage device with fdatasync (fsync where it is not available)
+	 */
+	virtual void sync();
+
+	/**
+	 * @brief Determines with isatty, if the file descriptor refers to a terminal
+	 */
+	virtual bool is_terminal() const { return m_terminal; }
+};
+
+
+} // namespace logcpp
+
+#endif
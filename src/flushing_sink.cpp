@@ -0,0 +1,118 @@
+/**
+ * @file flushing_sink.cpp
+ * @brief A sink that decides by a policy when its target is flushed and synced
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+    LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+    Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+    Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 3 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+    USA
+*/
+
+
+#include "flushing_sink.hpp"
+
+
+namespace logcpp {
+
+flushing_sink::flushing_sink( sink* target, const flush_policy& policy )
+    :   m_target( target )
+    ,   m_policy( policy )
+    ,   m_records( 0 )
+    ,   m_bytes( 0 )
+    ,   m_lock()
+    ,   m_wakeup()
+    ,   m_stop( false )
+    ,   m_timer()
+{
+    if ( m_policy.interval.count() > 0 ) {
+        m_timer = std::thread( &flushing_sink::run, this );
+    }
+}
+
+
+flushing_sink::~flushing_sink() {
+    {
+        std::lock_guard< std::mutex > guard( m_lock );
+        m_stop = true;
+    }
+    m_wakeup.notify_one();
+    if ( m_timer.joinable() ) {
+        m_timer.join();
+    }
+
+    std::lock_guard< std::mutex > guard( m_lock );
+    flush_target();
+}
+
+
+void flushing_sink::flush_target() {
+    if ( m_policy.sync ) {
+        m_target->sync();
+    } else {
+        m_target->flush();
+    }
+    m_records = 0;
+    m_bytes = 0;
+}
+
+
+void flushing_sink::run() {
+    std::unique_lock< std::mutex > lock( m_lock );
+    while ( !m_stop ) {
+        m_wakeup.wait_for( lock, m_policy.interval );
+        if ( m_records > 0 ) {
+            flush_target();
+        }
+    }
+}
+
+
+void flushing_sink::write( const record_view& record ) {
+    std::lock_guard< std::mutex > guard( m_lock );
+    m_target->write( record );
+    m_records++;
+    m_bytes += record.prefix_size + record.body_size + ( record.terminated ? 1 : 0 );
+
+    if ( ( m_policy.records > 0 && m_records >= m_policy.records )
+      || ( m_policy.bytes > 0 && m_bytes >= m_policy.bytes )
+      || ( record.severity > off && record.severity <= m_policy.severity ) ) {
+        flush_target();
+    }
+}
+
+
+void flushing_sink::flush() {}
+
+
+void flushing_sink::drain() {
+    std::lock_guard< std::mutex > guard( m_lock );
+    m_target->drain();
+    flush_target();
+}
+
+
+void flushing_sink::sync() {
+    std::lock_guard< std::mutex > guard( m_lock );
+    m_target->sync();
+    m_records = 0;
+    m_bytes = 0;
+}
+
+
+} // namespace logcpp
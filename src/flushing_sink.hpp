@@ -0,0 +1,163 @@
+/**
+ * @file flushing_sink.hpp
+ * @brief A sink that decides by a policy when its target is flushed and synced
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+	LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+	Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+	Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+	USA
+*/
+
+
+#pragma once
+
+#include "config.hpp"
+
+#include "severity_default.hpp"
+#include "sink.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+
+
+namespace logcpp {
+
+/**
+ * @brief When a flushing_sink flushes its target. A flush happens as soon as any enabled trigger fires.
+ */
+struct flush_policy {
+	/**
+	 * @brief Flush after this amount of records. 1 flushes every record, 0 disables the trigger.
+	 */
+	std::size_t records;
+	/**
+	 * @brief Flush after this amount of bytes. 0 disables the trigger.
+	 */
+	std::size_t bytes;
+	/**
+	 * @brief Flush pending records from a timer thread at most this long after they were written. 0 disables the timer.
+	 */
+	std::chrono::milliseconds interval;
+	/**
+	 * @brief Flush at once after records at least this critical (like logcpp::error). off disables the trigger.
+	 */
+	int severity;
+	/**
+	 * @brief Wether each flush waits until the records are stored durably (with fdatasync for a fd_sink). All records since the last flush share one sync.
+	 */
+	bool sync;
+
+	/**
+	 * @brief Constructor. Defaults to flushing every record like a logger without flushing_sink.
+	 * @param records The amount of records to flush after (0 for no limit)
+	 * @param bytes The amount of bytes to flush after (0 for no limit)
+	 * @param interval The longest time records stay unflushed (0 for no limit)
+	 * @param severity The least critical severity flushed at once (off for none)
+	 * @param sync Wether to sync the target on each flush
+	 */
+	explicit flush_policy( std::size_t records = 1, std::size_t bytes = 0, std::chrono::milliseconds interval = std::chrono::milliseconds( 0 ), int severity = off, bool sync = false )
+		:	records( records )
+		,	bytes( bytes )
+		,	interval( interval )
+		,	severity( severity )
+		,	sync( sync )
+	{}
+};
+
+
+/**
+ * @brief A sink that writes records to a target and flushes the target, when its flush_policy says so
+ * @note Loggers flush their sink after every record. A flushing_sink ignores that and batches records into few writes (and syncs) to the target instead.
+ * @note It is safe to use from several threads. If the policy has an interval, a timer thread flushes pending records.
+ */
+class flushing_sink
+	:	public sink
+{
+protected:
+	sink* m_target;
+	flush_policy m_policy;
+	/**
+	 * @brief The amount of records and bytes written since the last flush
+	 */
+	std::size_t m_records;
+	std::size_t m_bytes;
+
+	std::mutex m_lock;
+	std::condition_variable m_wakeup;
+	bool m_stop;
+	std::thread m_timer;
+
+	/**
+	 * @brief Flush (and sync) the target and reset the counters. Expects m_lock to be held.
+	 */
+	void flush_target();
+
+	/**
+	 * @brief The loop of the timer thread
+	 */
+	void run();
+
+public:
+	/**
+	 * @brief Constructor. Starts the timer thread, if the policy has an interval.
+	 * @param target The sink all records are written to
+	 * @param policy When to flush the target
+	 */
+	flushing_sink( sink* target, const flush_policy& policy );
+
+	flushing_sink( const flushing_sink& ) = delete;
+
+	/**
+	 * @brief Destructor. Stops the timer thread and flushes (and syncs) the target.
+	 */
+	virtual ~flushing_sink();
+
+	/**
+	 * @brief Write a record to the target and flush it, if a trigger of the policy fires
+	 */
+	virtual void write( const record_view& record );
+
+	/**
+	 * @brief Does nothing. The policy decides when the target is flushed.
+	 */
+	virtual void flush();
+
+	/**
+	 * @brief Drain the target (like an async_sink queue), then flush (and sync, if the policy says so) it at once
+	 */
+	virtual void drain();
+
+	/**
+	 * @brief Flush and sync the target at once
+	 */
+	virtual void sync();
+
+	virtual bool is_terminal() const { return m_target->is_terminal(); }
+
+	/**
+	 * @returns The policy of this sink
+	 */
+	const flush_policy& policy() const { return m_policy; }
+};
+
+
+} // namespace logcpp
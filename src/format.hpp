@@ -0,0 +1,142 @@
+/**
+ * @file format.hpp
+ * @brief Format strings that are parsed and checked at compile time
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+	LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+	Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+	Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+	USA
+*/
+
+
+
+
+#pragma once
+
+#include "config.hpp"
+
+#include "logstream.hpp"
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+
+/**
+ * @def LOGCPP_FORMAT(format_)
+ * @brief Turn a string literal like "user {} took {} ms" into a format string that is parsed at compile time
+ * @note Each {} is replaced by the next argument, {{ and }} insert single braces. Other uses of braces do not compile.
+ */
+#define LOGCPP_FORMAT(format_) \
+	[]() { struct logcpp_format_string { static constexpr std::string_view text() { return format_; } }; return logcpp_format_string(); }()
+
+
+namespace logcpp {
+
+/**
+ * @brief The literal text of a format string split at its placeholders
+ * @param size The amount of characters of the format string
+ */
+template< std::size_t size >
+struct format_layout {
+	/**
+	 * @brief The literal characters of all segments with escaped braces replaced
+	 */
+	char text[size + 1];
+	/**
+	 * @brief The end of each segment in text. A placeholder follows each segment but the last.
+	 */
+	std::size_t ends[size + 1];
+	/**
+	 * @brief The amount of segments, one more than the amount of placeholders
+	 */
+	std::size_t segments;
+};
+
+/**
+ * @brief Parse a format string. Only called at compile time, so a malformed format string stops the compilation at the throw.
+ */
+template< std::size_t size >
+constexpr format_layout< size > parse_format( std::string_view format ) {
+	format_layout< size > layout = {};
+	std::size_t length = 0;
+	std::size_t segment = 0;
+	for ( std::size_t i = 0; i < format.size(); i++ ) {
+		if ( format[i] == '{' && i + 1 < format.size() && format[i + 1] == '{' ) {
+			layout.text[length++] = '{';
+			i++;
+		} else if ( format[i] == '{' && i + 1 < format.size() && format[i + 1] == '}' ) {
+			layout.ends[segment++] = length;
+			i++;
+		} else if ( format[i] == '{' ) {
+			throw std::invalid_argument( "logcpp: a { in a format string has to be followed by } or {" );
+		} else if ( format[i] == '}' && i + 1 < format.size() && format[i + 1] == '}' ) {
+			layout.text[length++] = '}';
+			i++;
+		} else if ( format[i] == '}' ) {
+			throw std::invalid_argument( "logcpp: a single } in a format string has to be written as }}" );
+		} else {
+			layout.text[length++] = format[i];
+		}
+	}
+	layout.ends[segment++] = length;
+	layout.segments = segment;
+	return layout;
+}
+
+/**
+ * @brief A format string created with LOGCPP_FORMAT, parsed once at compile time
+ */
+template< typename format_t >
+struct compiled_format {
+	static constexpr std::string_view source = format_t::text();
+	static constexpr format_layout< source.size() > layout = parse_format< source.size() >( source );
+	/**
+	 * @brief The amount of arguments the format string takes
+	 */
+	static constexpr std::size_t arguments = layout.segments - 1;
+
+	/**
+	 * @returns The literal text in front of placeholder index (or behind the last one)
+	 */
+	template< std::size_t index >
+	static constexpr std::string_view segment() {
+		return std::string_view( layout.text + ( index == 0 ? 0 : layout.ends[index - 1] )
+		                       , layout.ends[index] - ( index == 0 ? 0 : layout.ends[index - 1] ) );
+	}
+};
+
+
+/**
+ * @brief Append the segments of a format string and its arguments to a record
+ * @note Compiles to one insert per segment and argument. The format string is not looked at during runtime.
+ * @note Strings and numbers are written straight into the record buffer by the inserters of logstreambuf.
+ */
+template< typename format_t, std::size_t... index, typename... Args >
+inline void format_record( logstreambuf& stream, std::index_sequence< index... >, const Args&... args ) {
+	typedef compiled_format< format_t > format;
+	( ( stream.insert( format::template segment< index >().data(), format::template segment< index >().size() )
+	  , stream << args ), ... );
+	stream.insert( format::template segment< sizeof...( index ) >().data(), format::template segment< sizeof...( index ) >().size() );
+}
+
+} // namespace logcpp
@@ -28,43 +28,85 @@
 #include "log.hpp"
 #include "logcppversion.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 
 namespace logcpp {
 
 std::string globallog::logfile = std::string( "./globallog.log" );
+rotation_policy globallog::rotation;
+std::atomic< globallog* > globallog::instance_( nullptr );
 std::unique_ptr< globallog > globallog::log_;
+std::once_flag globallog::init_flag_;
 
 
 globallog::globallog()
-    :   severity_log< default_severity_levels >( new DefaultSeverity(), normal )
-    ,   console_log( new severity_logger() )
+    :   severity_log< default_severity_levels >( &DefaultSeverity::instance, normal )
+    ,   config_lock()
+    ,   settings_generation( 1 )
+    ,   console_sink( std::cout.rdbuf() )
+    ,   console_channel( this, console, console_sink.is_terminal() )
+    ,   console_log( new severity_logger( &console_channel ) )
     ,   console_input_log( new basic_log_input(*console_log) )
     ,   file_log_enabled_(false)
+#ifdef __unix__
+    ,   file_sink( nullptr )
+#else
     ,   ofs( new std::ofstream )
+    ,   file_stream_sink( nullptr )
+#endif
+    ,   file_channel( this, file, false )
     ,   file_log( nullptr )
     ,   file_severity( normal )
+    ,   outputs{ { &console_sink, overflow_drop_below_severity }, { nullptr, overflow_block } }
 {}
 
-globallog& globallog::get() {
+globallog::channel_output::channel_output( sink* target, overflow_policy policy )
+    :   target( target )
+    ,   flushing()
+    ,   flusher( nullptr )
+    ,   async( nullptr )
+    ,   lock()
+    ,   depth( 0 )
+    ,   batch_size( async_sink::default_batch_size )
+    ,   policy( policy )
+    ,   severity_threshold( error )
+    ,   retired_dropped()
+{}
 
-    if( !log_ ) {
+globallog::thread_record::thread_record( globallog& owner )
+    :   out( &owner, this )
+    ,   body( &out )
+    ,   console{ normal, false, true, false }
+    ,   file{ off, false, true, false }
+    ,   file_enabled( false )
+    ,   started( false )
+    ,   severity( normal )
+    ,   generation( 0 )
+{}
+
+void globallog::init() {
+    std::call_once( init_flag_, [] {
         log_.reset( new globallog() );
-        stdlog.enable_print_severity(false);
-        stdlog << logcpp::warning;
+        globallog& log = *log_;
+
+        log.enable_print_severity(false);
+        log << logcpp::warning;
 #ifdef LOGCPP_ENABLE_COLOR_SUPPORT
-        stdlog << logcpp::sty_bold;
+        log << logcpp::sty_bold;
 #endif
 #ifdef LOGCPP_DISABLE_VERSION_PROMPT
-        stdlog << "LibLogC++ v" << LIBLOGCPP_DOTTED_VERSION << " (https://github.com/nullptrT/liblogcpp)";
+        log << "LibLogC++ v" << LIBLOGCPP_DOTTED_VERSION << " (https://github.com/nullptrT/liblogcpp)";
 #endif
 #ifdef LOGCPP_ENABLE_COLOR_SUPPORT
-        stdlog << logcpp::ctl_reset_all;
+        log << logcpp::ctl_reset_all;
 #endif
-        stdlog << logcpp::normal << logcpp::endrec;
-        stdlog.enable_print_severity();
-    }
+        log << logcpp::normal << logcpp::endrec;
+        log.enable_print_severity();
 
-    return *log_;
+        instance_.store( log_.get(), std::memory_order_release );
+    } );
 }
 
 
@@ -72,6 +114,13 @@ logcpp::globallog& globallog::operator<<( globallog& (*f)(globallog&) ) {
     return f(*this);
 }
 
+null_record globallog::operator<<( const stripped_severity& ) {
+    if( !local().body.is_new_record() ) {
+        end_record();
+    }
+    return null_record();
+}
+
 globallog& globallog::operator>>( globallog& (*f)(globallog& l) ) {
     return f(*this);
 }
@@ -83,40 +132,150 @@ globallog& globallog::operator>>( const logcpp::input_flag iflag ) {
 
 
 
-void globallog::end_record() {
-    *console_log << stream.get_buf() << endrec;
+globallog::thread_record& globallog::local() {
+    thread_local thread_record record( *this );
 
-    if( file_log_enabled_ ) {
-        *file_log << stream.get_buf() << endrec;
+    if( record.generation != settings_generation.load( std::memory_order_acquire ) ) {
+        apply_settings( record );
     }
+    return record;
+}
 
-    stream.clear_buf();
+void globallog::apply_settings( thread_record& record ) {
+    std::shared_lock< std::shared_mutex > lock( config_lock );
+    record.generation = settings_generation.load( std::memory_order_relaxed );
 
-    if( this->current_severity == critical && abort_f != nullptr ) {
+    record.console.max_severity = console_log->severity_max();
+    record.console.timestamps = console_log->timestamp_enabled();
+    record.console.print_severity = console_log->print_severity_enabled();
+#ifdef LOGCPP_ENABLE_COLOR_SUPPORT
+    record.console.colored = console_channel.is_terminal();
+#endif
+
+    record.file_enabled = ( file_log_enabled_ && file_log );
+    if( file_log ) {
+        record.file.max_severity = file_log->severity_max();
+        record.file.timestamps = file_log->timestamp_enabled();
+        record.file.print_severity = file_log->print_severity_enabled();
+    }
+
+    // The logger of the thread passes what any channel takes and formats a timestamp, if any channel prints it
+    default_severity_levels max_severity = record.console.max_severity;
+    bool timestamps = ( record.console.max_severity != off && record.console.timestamps );
+    if( record.file_enabled && record.file.max_severity != off ) {
+        max_severity = std::max( max_severity, record.file.max_severity );
+        timestamps = timestamps || record.file.timestamps;
+    }
+    record.body.set_max_severity_level( max_severity );
+    record.body.enable_print_severity( false );
+    if( timestamps ) record.body.enable_timestamp();
+    else record.body.disable_timestamp();
+    record.body.set_timestamp_format( console_log->time_format(), console_log->time_precision() );
+}
+
+void globallog::settings_changed() {
+    settings_generation.fetch_add( 1, std::memory_order_release );
+}
+
+void globallog::hand_over( channel_t channel, const record_view& record ) {
+    std::shared_lock< std::shared_mutex > config( config_lock );
+    channel_output& output = outputs[channel];
+
+    if( output.async ) { // The queue of an async_sink takes records of many threads at once
+        output.async->write( record );
+        return;
+    }
+
+    sink* target = output.delivery();
+    if( target == nullptr ) {
+        return;
+    }
+    std::lock_guard< std::mutex > guard( output.lock );
+    target->write( record );
+    target->flush();
+}
+
+void globallog::fan_out( thread_record& record, const record_view& view ) {
+    const bool started = ( record.started || view.prefix_size + view.body_size > 0 );
+    record.started = false;
+
+    const int severity = view.severity;
+    if( severity <= record.console.max_severity && record.console.max_severity != off ) {
+        write_channel( console, record.console, started, view );
+    }
+    if( record.file_enabled && severity <= record.file.max_severity && record.file.max_severity != off ) {
+        write_channel( file, record.file, started, view );
+    }
+}
+
+void globallog::write_channel( channel_t channel, const channel_settings& settings, bool started, const record_view& view ) {
+    char prefix[max_timestamp_size + 64];   // The timestamp with its separator and the longest colored severity prefix
+    std::size_t size = 0;
+    if( settings.timestamps ) {
+        std::memcpy( prefix, view.prefix, view.prefix_size );
+        size = view.prefix_size;
+    }
+    if( settings.print_severity && started && view.severity != record_view::no_severity ) {
+        const std::string_view name = DefaultSeverity::instance.prefix( static_cast< default_severity_levels >( view.severity ), settings.colored );
+        std::memcpy( prefix + size, name.data(), name.size() );
+        size += name.size();
+    }
+    record_view record = { prefix, size, view.body, view.body_size, view.terminated, view.severity };
+    hand_over( channel, record );
+}
+
+void globallog::drain_channel( channel_t channel ) {
+    std::shared_lock< std::shared_mutex > config( config_lock );
+
+    channel_output& output = outputs[channel];
+    if( output.async ) {
+        output.async->drain();
+    }
+    if( output.flusher ) {  // Flushing a flushing_sink is left to its policy, so the queue does not reach the file by draining alone
+        output.flusher->drain();
+    }
+}
+
+void globallog::end_record() {
+    thread_record& record = local();
+    record.started = !record.body.is_new_record();
+    record.body << endrec;
+
+    if( record.severity == critical && abort_f != nullptr ) {
+        drain_channel( console );
+        drain_channel( file );
         abort_f();
     }
 }
 
 void globallog::end_line () {
-    *console_log << endl;
+    local().body << endl;
 
-    if( file_log_enabled_ ) {
-        *file_log << endl;
-    }
+}
+
+default_severity_levels globallog::severity() {
+    return local().severity;
+}
 
+bool globallog::will_log( default_severity_levels severity ) {
+    return local().body.will_log( severity );
 }
 
 void globallog::set_max_console_severity(default_severity_levels level) {
+    std::unique_lock< std::shared_mutex > lock( config_lock );
     this->max_severity_lvl = level;
     console_log->set_max_severity_level( level );
+    settings_changed();
 }
 
 
 void globallog::set_max_file_severity(default_severity_levels level) {
+    std::unique_lock< std::shared_mutex > lock( config_lock );
     if ( file_log_enabled_ ) {
         file_log->set_max_severity_level( level );
     }
     this->file_severity = level;
+    settings_changed();
 }
 
 
@@ -126,35 +285,64 @@ void globallog::set_max_severity_level(default_severity_levels level) {
 }
 
 void globallog::set_logfile_impl() {
+    std::unique_lock< std::shared_mutex > lock( config_lock );
+    disconnect( outputs[file] );
+#ifdef __unix__
+    file_sink.reset( nullptr );    // Close the current file before a rotating sink looks at it
+    if( rotation.enabled() ) {
+        file_sink.reset( new rotating_file_sink( globallog::logfile, rotation ) );
+    } else {
+        file_sink.reset( new fd_sink( globallog::logfile ) );
+    }
+    outputs[file].target = file_sink.get();
+#else
     if( ofs->is_open() ) { // Close the current file, if open
         ofs->close();
     }
     ofs->open( globallog::logfile, std::ofstream::out | std::ofstream::app | std::ofstream::ate);
-    file_log.reset( new severity_logger( ofs->rdbuf(), this->file_severity ) );
+    file_stream_sink.reset( new streambuf_sink( ofs->rdbuf() ) );
+    outputs[file].target = file_stream_sink.get();
+#endif
+    connect( outputs[file] );
 #ifdef LOGCPP_DISABLE_VERSION_PROMPT
-    file_log->enable_print_severity(false);
-    *file_log << logcpp::warning << "LibLogC++ v" << LIBLOGCPP_DOTTED_VERSION << " (https://github.com/nullptrT/liblogcpp)" << file_severity << logcpp::endrec;
-    file_log->enable_print_severity();
+    sink* target = outputs[file].async ? outputs[file].async.get() : outputs[file].delivery();
+    severity_logger banner( target, this->file_severity );  // The channel is locked, so the banner bypasses it
+    banner.enable_print_severity(false);
+    banner << logcpp::warning << "LibLogC++ v" << LIBLOGCPP_DOTTED_VERSION << " (https://github.com/nullptrT/liblogcpp)" << file_severity << logcpp::endrec;
 #endif
+    file_log.reset( new severity_logger( &file_channel, this->file_severity ) );
     file_log->enable_timestamp();
+    file_log->set_timestamp_format( time_format_, time_precision_ );
+    settings_changed();
 }
 
 void globallog::set_logfile(const std::string file) {
     logfile = file;
+    rotation = rotation_policy();
+    get().set_logfile_impl();
+}
+
+void globallog::set_logfile( const std::string file, const rotation_policy& policy ) {
+    logfile = file;
+    rotation = policy;
     get().set_logfile_impl();
 }
 
 void globallog::use_timestamps_console(bool use) {
+    std::unique_lock< std::shared_mutex > lock( config_lock );
     if(use) console_log-> enable_timestamp();
     else console_log->disable_timestamp();
+    settings_changed();
 }
 
 void globallog::use_timestamps_file(bool use) {
     if( !file_log ) {
         set_logfile_impl();
     }
+    std::unique_lock< std::shared_mutex > lock( config_lock );
     if(use) file_log-> enable_timestamp();
     else file_log->disable_timestamp();
+    settings_changed();
 }
 
 void globallog::enable_timestamp() {
@@ -169,16 +357,30 @@ void globallog::disable_timestamp() {
     basic_log::disable_timestamp();
 }
 
+void globallog::set_timestamp_format( timestamp_format format, timestamp_precision precision ) {
+    std::unique_lock< std::shared_mutex > lock( config_lock );
+    console_log->set_timestamp_format( format, precision );
+    if( file_log ) {
+        file_log->set_timestamp_format( format, precision );
+    }
+    basic_log::set_timestamp_format( format, precision );
+    settings_changed();
+}
+
 void globallog::enable_print_severity( bool enable ) {
+    std::unique_lock< std::shared_mutex > lock( config_lock );
     console_log->enable_print_severity( enable );
 
     if( file_log_enabled_ ) {
         file_log->enable_print_severity( enable );
     }
+    settings_changed();
 }
 
 void globallog::enable_console_log_impl() {
+    std::unique_lock< std::shared_mutex > lock( config_lock );
     console_log->set_max_severity_level( this->max_severity_lvl );
+    settings_changed();
 }
 
 void globallog::enable_console_log() {
@@ -186,7 +388,9 @@ void globallog::enable_console_log() {
 }
 
 void globallog::disable_console_log_impl() {
+    std::unique_lock< std::shared_mutex > lock( config_lock );
     console_log->set_max_severity_level( off );
+    settings_changed();
 }
 
 void globallog::disable_console_log() {
@@ -197,8 +401,10 @@ void globallog::enable_file_log_impl() {
     if( !file_log ) {
         set_logfile_impl();
     }
+    std::unique_lock< std::shared_mutex > lock( config_lock );
     file_log->set_max_severity_level( this->file_severity );
     file_log_enabled_ = true;
+    settings_changed();
 }
 
 void globallog::enable_file_log() {
@@ -206,14 +412,145 @@ void globallog::enable_file_log() {
 }
 
 void globallog::disable_file_log_impl() {
-    file_log->set_max_severity_level( off );
+    std::unique_lock< std::shared_mutex > lock( config_lock );
+    if( file_log ) {
+        file_log->set_max_severity_level( off );
+    }
     file_log_enabled_ = false;
+    settings_changed();
 }
 
 void globallog::disable_file_log() {
     get().disable_file_log_impl();
 }
 
+void globallog::connect( channel_output& output ) {
+    disconnect( output );
+    if( output.target == nullptr ) {
+        return;
+    }
+    if( output.flushing.records != 1 || output.flushing.sync ) {
+        output.flusher.reset( new flushing_sink( output.target, output.flushing ) );
+    }
+    if( output.depth > 0 ) {
+        output.async.reset( new async_sink( output.delivery(), output.depth, output.batch_size ) );
+        output.async->set_overflow_policy( output.policy, output.severity_threshold );
+    }
+}
+
+void globallog::disconnect( channel_output& output ) {
+    stop_async( output );
+    output.flusher.reset();
+}
+
+void globallog::stop_async( channel_output& output ) {
+    if( !output.async ) {
+        return;
+    }
+    for( std::size_t i = 0; i <= LOGCPP_ASYNC_MAX_SEVERITIES; i++ ) {   // Index 0 counts records without severity
+        output.retired_dropped[i] += output.async->dropped( static_cast< int >( i ) - 1 );
+    }
+    output.async.reset();
+    if( output.flusher ) {
+        output.flusher->drain();
+    }
+}
+
+void globallog::enable_async_impl( channel_t channel, std::size_t depth, std::size_t batch_size ) {
+    std::unique_lock< std::shared_mutex > lock( config_lock );
+    channel_output& output = outputs[channel];
+    output.depth = depth;
+    output.batch_size = batch_size;
+    connect( output );
+}
+
+void globallog::enable_async( std::size_t depth ) {
+    globallog& log = get();
+    log.enable_async_impl( console, depth, async_sink::default_batch_size );
+    log.enable_async_impl( file, depth, async_sink::default_batch_size );
+}
+
+void globallog::enable_async( channel_t channel, std::size_t depth, std::size_t batch_size ) {
+    get().enable_async_impl( channel, depth, batch_size );
+}
+
+void globallog::disable_async_impl( channel_t channel ) {
+    std::unique_lock< std::shared_mutex > lock( config_lock );
+    outputs[channel].depth = 0;
+    stop_async( outputs[channel] );
+}
+
+void globallog::disable_async() {
+    globallog& log = get();
+    log.disable_async_impl( console );
+    log.disable_async_impl( file );
+}
+
+void globallog::disable_async( channel_t channel ) {
+    get().disable_async_impl( channel );
+}
+
+void globallog::set_async_overflow_policy( overflow_policy policy, default_severity_levels severity_threshold ) {
+    set_async_overflow_policy( console, policy, severity_threshold );
+    set_async_overflow_policy( file, policy, severity_threshold );
+}
+
+void globallog::set_async_overflow_policy( channel_t channel, overflow_policy policy, default_severity_levels severity_threshold ) {
+    globallog& log = get();
+    std::unique_lock< std::shared_mutex > lock( log.config_lock );
+    channel_output& output = log.outputs[channel];
+    output.policy = policy;
+    output.severity_threshold = severity_threshold;
+
+    if( output.async ) {
+        output.async->set_overflow_policy( policy, severity_threshold );
+    }
+}
+
+void globallog::set_flush_policy( channel_t channel, const flush_policy& policy ) {
+    globallog& log = get();
+    std::unique_lock< std::shared_mutex > lock( log.config_lock );
+    channel_output& output = log.outputs[channel];
+    output.flushing = policy;
+    log.connect( output );
+}
+
+bool globallog::async_enabled() const {
+    return ( async_enabled( console ) || async_enabled( file ) );
+}
+
+bool globallog::async_enabled( channel_t channel ) const {
+    return ( outputs[channel].depth > 0 );
+}
+
+std::size_t globallog::dropped( channel_t channel, default_severity_levels severity ) {
+    std::shared_lock< std::shared_mutex > lock( config_lock );
+    const channel_output& output = outputs[channel];
+
+    std::size_t count = 0;
+    if( severity >= 0 && severity < LOGCPP_ASYNC_MAX_SEVERITIES ) {
+        count = output.retired_dropped[static_cast< std::size_t >( severity ) + 1];
+    }
+    if( output.async ) {
+        count += output.async->dropped( severity );
+    }
+    return count;
+}
+
+std::size_t globallog::dropped_total( channel_t channel ) {
+    std::shared_lock< std::shared_mutex > lock( config_lock );
+    const channel_output& output = outputs[channel];
+
+    std::size_t count = 0;
+    for( std::size_t i = 0; i <= LOGCPP_ASYNC_MAX_SEVERITIES; i++ ) {
+        count += output.retired_dropped[i];
+    }
+    if( output.async ) {
+        count += output.async->dropped_total();
+    }
+    return count;
+}
+
 bool globallog::console_log_enabled() const {
     return ( console_log
              && console_log->severity_max() != off );
@@ -26,52 +26,312 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <fstream>
+#include <shared_mutex>
 
 #include "config.hpp"
 
+#include "async_sink.hpp"
 #include "basic_log_input.hpp"
+#include "fd_sink.hpp"
+#include "flushing_sink.hpp"
+#include "rotating_file_sink.hpp"
 #include "severity_logger.hpp"
 
 namespace logcpp {
 
 /**
  * @brief A global singleton logger with severities that has a console and a file channel
+ * @note Each thread writes its records into loggers of its own. Threads only synchronize, when a finished record is handed to a channel.
+ * @note Final, so the compiler can devirtualize severity_log::log_severity on the logging path
  */
-class globallog
+class globallog final
 	:  public severity_log< default_severity_levels >
 {
 private:
+	/**
+	 * @brief The logger once it is initialized. Constant initialized, so it is safe to read before main.
+	 */
+	static std::atomic< globallog* > instance_;
 	static std::unique_ptr< globallog > log_;
+	static std::once_flag init_flag_;
 
 	static std::string logfile;
+	static rotation_policy rotation;
 	
 	globallog();
 	globallog(globallog const& another) = delete;
 	globallog& operator=(globallog const& another);
 
+public:
+	/**
+	 * @brief The channels of the globallog. Each channel delivers its records independently.
+	 */
+	enum channel_t {
+		console,
+		file
+	};
+
 protected:
+	/**
+	 * @brief The sink the loggers of all threads write one channel to. Hands each finished record to the current target of the channel.
+	 */
+	class channel_sink
+		:	public sink
+	{
+	protected:
+		globallog* m_owner;
+		channel_t m_channel;
+		bool m_terminal;
+
+	public:
+		channel_sink( globallog* owner, channel_t channel, bool terminal )
+			:	m_owner( owner )
+			,	m_channel( channel )
+			,	m_terminal( terminal )
+		{}
+
+		virtual void write( const record_view& record ) { m_owner->hand_over( m_channel, record ); }
+
+		/**
+		 * @brief Does nothing. Records are flushed when they are handed over.
+		 */
+		virtual void flush() {}
+
+		virtual void drain() { m_owner->drain_channel( m_channel ); }
+
+		virtual bool is_terminal() const { return m_terminal; }
+	};
+
+	struct thread_record;
+
+	/**
+	 * @brief The sink of the logger of one thread. Hands each finished record to both channels with the prefix of each channel.
+	 */
+	class record_sink
+		:	public sink
+	{
+	protected:
+		globallog* m_owner;
+		thread_record* m_record;
+
+	public:
+		record_sink( globallog* owner, thread_record* record )
+			:	m_owner( owner )
+			,	m_record( record )
+		{}
+
+		virtual void write( const record_view& record ) { m_owner->fan_out( *m_record, record ); }
+
+		/**
+		 * @brief Does nothing. Records are flushed when they are handed over.
+		 */
+		virtual void flush() {}
+
+		virtual void drain() {
+			m_owner->drain_channel( console );
+			m_owner->drain_channel( file );
+		}
+
+		virtual bool is_terminal() const { return m_owner->console_channel.is_terminal(); }
+	};
+
+	/**
+	 * @brief The settings of a channel as copied to the record of a thread
+	 */
+	struct channel_settings {
+		default_severity_levels max_severity;
+		bool timestamps;
+		bool print_severity;
+		bool colored;
+	};
+
+	/**
+	 * @brief The record of one thread. Its timestamp and body are formatted once for both channels (console and file).
+	 */
+	struct thread_record {
+		record_sink out;
+		/**
+		 * @brief Formats the timestamp as prefix and the body. Passes the severities of both channels and prints no severity name.
+		 */
+		severity_logger body;
+		channel_settings console;
+		channel_settings file;
+		bool file_enabled;
+		/**
+		 * @brief Wether the record that is ended had content or a severity inserted, so that it gets a severity prefix
+		 */
+		bool started;
+		default_severity_levels severity;
+		unsigned long generation;
+
+		explicit thread_record( globallog& owner );
+	};
+
+	/**
+	 * @brief Where the records of a channel are written to and how they get there
+	 */
+	struct channel_output {
+		/**
+		 * @brief The sink of the channel or nullptr, if it has none yet
+		 */
+		sink* target;
+		/**
+		 * @brief When the target is flushed. A flushing_sink is put in front of the target, unless every record is flushed.
+		 */
+		flush_policy flushing;
+		std::unique_ptr< flushing_sink > flusher;
+		/**
+		 * @brief The queue and writer thread of the channel, if it is asynchronous
+		 */
+		std::unique_ptr< async_sink > async;
+		/**
+		 * @brief Serializes records written to the target, if the channel is not asynchronous
+		 */
+		std::mutex lock;
+		/**
+		 * @brief The amount of records the queue holds. Zero, if the channel is written in end_record.
+		 */
+		std::size_t depth;
+		/**
+		 * @brief The amount of records the writer thread writes before it flushes the target
+		 */
+		std::size_t batch_size;
+		overflow_policy policy;
+		int severity_threshold;
+		/**
+		 * @brief Records dropped by queues of this channel that were replaced since
+		 */
+		std::size_t retired_dropped[LOGCPP_ASYNC_MAX_SEVERITIES + 1];
+
+		channel_output( sink* target, overflow_policy policy );
+
+		/**
+		 * @returns The sink records of the channel are written to, if it is not asynchronous
+		 */
+		sink* delivery() const { return flusher ? static_cast< sink* >( flusher.get() ) : target; }
+	};
+
+	/**
+	 * @brief Guards the targets of both channels. Handing over a record holds it shared, changing a target holds it exclusively.
+	 */
+	std::shared_mutex config_lock;
+	/**
+	 * @brief Incremented whenever a setting changes, so that the record of each thread picks it up
+	 */
+	std::atomic< unsigned long > settings_generation;
+
+    streambuf_sink console_sink;
+    channel_sink console_channel;
+    /**
+     * @brief Holds the settings of the console channel and writes its input prompts
+     */
     std::unique_ptr< severity_logger > console_log;
     std::unique_ptr< basic_log_input > console_input_log;
 
 	bool file_log_enabled_;
+#ifdef __unix__
+	std::unique_ptr< fd_sink > file_sink;
+#else
 	std::ofstream* ofs;
+	std::unique_ptr< streambuf_sink > file_stream_sink;
+#endif
+	channel_sink file_channel;
+	/**
+	 * @brief Holds the settings of the file channel
+	 */
 	std::unique_ptr< severity_logger > file_log;
 	default_severity_levels file_severity;
+	/**
+	 * @brief The delivery of each channel, indexed by channel_t
+	 */
+	channel_output outputs[2];
     
 	void enable_console_log_impl();
 	void disable_console_log_impl();
 	void enable_file_log_impl();
 	void disable_file_log_impl();
 	void set_logfile_impl();
+	void enable_async_impl( channel_t channel, std::size_t depth, std::size_t batch_size );
+	void disable_async_impl( channel_t channel );
+
+	/**
+	 * @brief Put a flushing_sink and a queue in front of the target of a channel, as its settings say. Expects config_lock to be held exclusively.
+	 */
+	void connect( channel_output& output );
+
+	/**
+	 * @brief Write all pending records of a channel to its target and remove what connect put in front of it. Expects config_lock to be held exclusively.
+	 */
+	void disconnect( channel_output& output );
+
+	/**
+	 * @brief Write all queued records of a channel to its target, keep its drop counts and stop its writer thread. Expects config_lock to be held exclusively.
+	 */
+	void stop_async( channel_output& output );
+
+	/**
+	 * @brief Notify the records of all threads about a changed setting
+	 */
+	void settings_changed();
+
+	/**
+	 * @brief Copy the current settings of both channels to the record of a thread
+	 */
+	void apply_settings( thread_record& record );
+
+	/**
+	 * @returns The record of the calling thread, up to date with the current settings
+	 */
+	thread_record& local();
+
+	/**
+	 * @brief Write a finished record to the current target of a channel
+	 * @param channel The channel the record belongs to
+	 * @param record The record to write
+	 */
+	void hand_over( channel_t channel, const record_view& record );
+
+	/**
+	 * @brief Hand a record formatted by the logger of a thread to each channel that takes its severity
+	 * @param record The record of the thread
+	 * @param view The timestamp (as prefix) and the body of the record
+	 */
+	void fan_out( thread_record& record, const record_view& view );
+
+	/**
+	 * @brief Hand a record to a channel with the prefix variant of the channel (timestamp and plain or colored severity)
+	 */
+	void write_channel( channel_t channel, const channel_settings& settings, bool started, const record_view& view );
+
+	/**
+	 * @brief Block until all records of a channel reached their target
+	 * @param channel The channel to drain
+	 */
+	void drain_channel( channel_t channel );
 
 public:
 
+	/**
+	 * @brief Create the logger and write the version banner, if not done yet
+	 * @note Call this at startup, so that the first record of some thread does not pay for it. get() calls it otherwise.
+	 */
+	static void init();
+
 	/**
 	 * @brief Get a reference to the logger object
 	 */
-	static globallog& get();
+	static globallog& get() {
+		globallog* log = instance_.load( std::memory_order_acquire );
+		if( log != nullptr ) {
+			return *log;
+		}
+		init();
+		return *instance_.load( std::memory_order_acquire );
+	}
 
 	/**
 	 * @brief Override of severity_log::operator<< for functions
@@ -88,6 +348,11 @@ public:
 		this->log<T>(t);
 		return *this;
 	}
+
+	/**
+	 * @brief Override of severity_log::operator<< for severities stripped at compile time
+	 */
+	null_record operator<<(const stripped_severity&);
     
 	/**
 	 * @brief Forward declaration of basic_log_input::operator>> for functions
@@ -119,6 +384,14 @@ public:
 	 */
 	static void set_logfile( std::string file );
 
+	/**
+	 * @brief Set a file to log to that rolls over by size or time and enable the file channel
+	 * @param file A path to the file to log to
+	 * @param policy When to roll over, how many closed segments to keep and wether to compress them
+	 * @note Rotation needs UNIX. Elsewhere the file is opened without it.
+	 */
+	static void set_logfile( std::string file, const rotation_policy& policy );
+
 	/**
 	 * @brief Sets the maximum severity level of messages sent to the console log
 	 * @param level The maximum severity level to be used
@@ -158,6 +431,13 @@ public:
 	 */
 	void disable_timestamp();
 
+	/**
+	 * @brief Overrides basic_log::set_timestamp_format and applies it to both channels (console and file)
+	 * @param format The layout (defaults to time_default like %F_%T)
+	 * @param precision The fraction of a second to append (defaults to time_seconds)
+	 */
+	void set_timestamp_format( timestamp_format format, timestamp_precision precision = time_seconds );
+
 	/**
 	 * @brief Enable logging of severity names or not
 	 * @param enable Enable or disable printing of severity names
@@ -184,6 +464,88 @@ public:
 	 */
 	static void disable_file_log();
 
+	/**
+	 * @brief Hand records of both channels (console and file) to a writer thread instead of writing them in end_record
+	 * @param depth The amount of records each channel can queue
+	 */
+	static void enable_async( std::size_t depth = async_sink::default_depth );
+
+	/**
+	 * @brief Give a channel a queue and a writer thread of its own, so that a stalled target of one channel does not hold up the other
+	 * @param channel The channel to make asynchronous
+	 * @param depth The amount of records the channel can queue
+	 * @param batch_size The amount of records the writer thread writes before it flushes the target of the channel
+	 */
+	static void enable_async( channel_t channel, std::size_t depth = async_sink::default_depth, std::size_t batch_size = async_sink::default_batch_size );
+
+	/**
+	 * @brief Write all queued records and write records of both channels in end_record again
+	 */
+	static void disable_async();
+
+	/**
+	 * @brief Write all queued records of a channel and write its records in end_record again
+	 * @param channel The channel to make synchronous
+	 */
+	static void disable_async( channel_t channel );
+
+	/**
+	 * @brief Choose what happens with records of both channels, when their queue is full in asynchronous mode
+	 * @param policy The overflow policy to use
+	 * @param severity_threshold For overflow_drop_below_severity: The least critical severity that is never dropped
+	 */
+	static void set_async_overflow_policy( overflow_policy policy, default_severity_levels severity_threshold = error );
+
+	/**
+	 * @brief Choose what happens with records of a channel, when its queue is full in asynchronous mode
+	 * @param channel The channel to configure
+	 * @param policy The overflow policy to use (console: overflow_drop_below_severity, file: overflow_block by default)
+	 * @param severity_threshold For overflow_drop_below_severity: The least critical severity that is never dropped
+	 */
+	static void set_async_overflow_policy( channel_t channel, overflow_policy policy, default_severity_levels severity_threshold = error );
+
+	/**
+	 * @brief Choose when the target of a channel is flushed (and synced). Defaults to flushing every record.
+	 * @param channel The channel to configure
+	 * @param policy The flush policy, like logcpp::flush_policy( 0, 0, std::chrono::milliseconds( 200 ), logcpp::error ) to flush every 200 ms and at once after errors
+	 */
+	static void set_flush_policy( channel_t channel, const flush_policy& policy );
+
+	/**
+	 * @return Wether records of any channel are written by a writer thread or not
+	 */
+	bool async_enabled() const;
+
+	/**
+	 * @return Wether records of a channel are written by a writer thread or not
+	 */
+	bool async_enabled( channel_t channel ) const;
+
+	/**
+	 * @return The amount of records of a channel with a specific severity dropped, because its queue was full
+	 * @param channel The channel to count for
+	 * @param severity The severity to count
+	 */
+	std::size_t dropped( channel_t channel, default_severity_levels severity );
+
+	/**
+	 * @return The amount of records of a channel dropped, because its queue was full
+	 * @param channel The channel to count for
+	 */
+	std::size_t dropped_total( channel_t channel );
+
+	/**
+	 * @return The severity of the record the calling thread is writing
+	 */
+	default_severity_levels severity();
+
+	/**
+	 * @brief Override of severity_feature::will_log for both channels (console and file)
+	 * @param severity The severity to check
+	 * @return Wether a record of that severity would be written to any channel
+	 */
+	bool will_log( default_severity_levels severity );
+
 	/**
 	 * @return Wether logging to console channel is enabled or not
 	 */
@@ -220,11 +582,7 @@ public:
 	 */
 	template< typename T >
 	void log( const T& t) {
-		*console_log << t;
-
-		if( file_log_enabled_ ) {
-			*file_log << t;
-		}
+		local().body << t;
 	}
 
 	/**
@@ -233,17 +591,28 @@ public:
 	 */
 	template< typename T >
 	void log( const default_severity_levels& severity ) {
-		if( this->stream.has_buffered_content() ) {
-			this->log< std::string >( this->stream.get_buf() );
-		}
-
-		*console_log << severity;
+		thread_record& record = local();
+		record.body << severity;
+		record.severity = severity;
+	}
 
-		if( file_log_enabled_ ) {
-			*file_log << severity;
+	/**
+	 * @brief Override of severity_log::log that writes a complete record from a format string to both channels (console and file)
+	 * @param severity The severity of the record
+	 * @param format A format string created with LOGCPP_FORMAT. The amount of placeholders is checked against args at compile time.
+	 * @param args The arguments that replace the placeholders {} in order
+	 */
+	template< typename format_t, typename... Args >
+	void log( const default_severity_levels severity, format_t format, const Args&... args ) {
+		thread_record& record = local();
+		record.started = true;
+		record.body.log( severity, format, args... );
+		record.severity = severity;
+		if( severity == critical && abort_f != nullptr ) {
+			drain_channel( console );
+			drain_channel( file );
+			abort_f();
 		}
-
-		this->current_severity = severity;
 	}
 
 	/**
@@ -255,6 +624,17 @@ public:
 		this->log< default_severity_levels >(sev_scope.first);
 		this->log< scope_t >(sev_scope.second);
 	}
+
+	/**
+	 * @brief Override of severity_log::log that inserts the severity and the call_site into both channels (console and file)
+	 * @param sev_site The severity_site_t to log
+	 */
+	template<typename T>
+	void log( const severity_site_t& sev_site ) {
+		thread_record& record = local();
+		record.body << sev_site;
+		record.severity = sev_site.first;
+	}
     
     /**
      * @brief Forward declaration of basic_log_input::get_input
@@ -273,11 +653,12 @@ public:
 	/**
 	 * @brief Member function that controls colors and styles of the underlying sink
 	 * @param mode Some value of color
+	 * @note The codes are part of the body, so they reach the file channel as well
 	 */
 	template< typename T >
 	void log( const termmode& mode ) {
 		if ( m_color_ok ) {
-            *console_log << mode;
+            local().body << mode;
 		}
 	}
 #endif
@@ -34,15 +34,14 @@
 namespace logcpp {
 
 /**
- * @brief Conversion compliance function to be able to pass QString to a logstreambuf
- * @param out A sink of a logger
- * @param str A QString to log
- * @returns A reference to the sink
+ * @brief Inserts a QString as UTF-8 straight into the record buffer without a temporary std::string
  */
-inline logstreambuf& operator<<(logstreambuf& out, const QString& str) {
-  out << str.toStdString();
-  return out;
-}
+template<>
+struct formatter< QString > {
+	static void format( logstreambuf& out, const QString& str ) {
+		insert_utf16( out, reinterpret_cast< const char16_t* >( str.utf16() ), static_cast< std::size_t >( str.size() ) );
+	}
+};
 
 
 } // namespace logcpp
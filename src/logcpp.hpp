@@ -26,6 +26,7 @@
 
 
 #include "channel_log.hpp"
+#include "fd_sink.hpp"
 #include "log.hpp"
 #include "logcppversion.hpp"
 
@@ -30,8 +30,20 @@
 
 
 
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <locale>
+#include <ratio>
 #include <ostream>
-#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "record_buffer.hpp"
+#include "sink.hpp"
 
 
 
@@ -48,42 +60,185 @@ protected:
 	 * @brief The buffer of a log stream buffer
 	 */
 	class logbuffer
-		:	public std::stringbuf
+		:	public record_buffer
 	{
     protected:
-		std::ostream out;
+		streambuf_sink m_streambuf_sink;
+		sink* m_sink;
+		std::size_t m_prefix_end;
+		bool m_terminate;
+		int m_severity;
+
 	public:
 		/**
 		 * @brief The constructor
 		 * @param outbuf A pointer to some streambuf where all buffered content is written to when flushed
 		 */
 		logbuffer(std::streambuf* outbuf)
-			:	out( outbuf )
+			:	m_streambuf_sink( outbuf )
+			,	m_sink( &m_streambuf_sink )
+			,	m_prefix_end( 0 )
+			,	m_terminate( false )
+			,	m_severity( record_view::no_severity )
+		{}
+
+		/**
+		 * @brief The constructor
+		 * @param out A pointer to some sink where all buffered content is written to when flushed
+		 */
+		logbuffer(sink* out)
+			:	m_streambuf_sink( nullptr )
+			,	m_sink( out )
+			,	m_prefix_end( 0 )
+			,	m_terminate( false )
+			,	m_severity( record_view::no_severity )
 		{}
 		
 		virtual ~logbuffer() {}
 
 		/**
-		 * @brief Write the rest of the buffered content to the target stream and flush it
+		 * @brief Mark everything buffered so far as prefix of the current record
+		 */
+		void end_prefix() {
+			m_prefix_end = size();
+		}
+
+		/**
+		 * @brief Let the next sync end the current record with a newline
+		 */
+		void terminate() {
+			m_terminate = true;
+		}
+
+		/**
+		 * @brief Set the severity that is handed to the sink with the current record
+		 * @param severity The severity as integer
+		 */
+		void set_severity( int severity ) {
+			m_severity = severity;
+		}
+
+		/**
+		 * @returns The severity that is handed to the sink with the current record
+		 */
+		int severity() const {
+			return m_severity;
+		}
+
+		/**
+		 * @brief Write bytes to the target sink as a record of their own without touching the current record
+		 * @param data Pointer to the first byte
+		 * @param size The amount of bytes
+		 */
+		void write_through( const char* data, std::size_t size ) {
+			record_view record = { data, 0, data, size, false, record_view::no_severity };
+			m_sink->write( record );
+		}
+
+		/**
+		 * @brief Drop the current record
+		 */
+		void discard() {
+			reset();
+			m_prefix_end = 0;
+			m_terminate = false;
+			m_severity = record_view::no_severity;
+		}
+
+		/**
+		 * @brief Write the rest of the buffered content to the target sink and flush it
 		 */
 		virtual int sync() {
-			out << str();
-			str("");
-			out.flush();
+			if ( size() > 0 || m_terminate ) {
+				record_view record = { data(), m_prefix_end, data() + m_prefix_end, size() - m_prefix_end, m_terminate, m_severity };
+				m_sink->write( record );
+				discard();
+			}
+			m_sink->flush();
 			return 0;
 		}
 		
 		/**
-		 * @brief Determines, if the underlying stream is a terminal
-		 * @note Will fail in some cases where a terminal supports positioning
+		 * @brief Determines, if the underlying sink is a terminal
 		 */
 		bool sink_is_terminal() {
-			return ( (int)out.tellp() == -1 );
+			return m_sink->is_terminal();
+		}
+
+		/**
+		 * @brief Write all further records to another sink
+		 * @param out The new sink or nullptr to write to the streambuf given on construction again
+		 */
+		void set_sink( sink* out ) {
+			m_sink = ( out != nullptr ? out : &m_streambuf_sink );
+		}
+
+		/**
+		 * @brief Block until all records written so far reached the target of the sink
+		 */
+		void drain() {
+			m_sink->drain();
 		}
 	};
 
 	logbuffer buf;
 
+	/**
+	 * @brief Wether numbers can be formatted without the facets of the locale of this stream, because it is the classic locale
+	 */
+	bool m_classic_numbers;
+
+	/**
+	 * @brief Updates #m_classic_numbers, when a locale is imbued into the stream
+	 */
+	static void locale_changed( std::ios_base::event event, std::ios_base& stream, int ) {
+		if ( event == std::ios_base::imbue_event ) {
+			logstreambuf* self = dynamic_cast< logstreambuf* >( &stream );
+			if ( self != nullptr ) {
+				self->m_classic_numbers = ( stream.getloc() == std::locale::classic() );
+			}
+		}
+	}
+
+	/**
+	 * @brief Move a formatted number to out, pad it to the field width like std::num_put does and add it to the record
+	 * @param out Pointer returned by prepare with room for the field width and the number
+	 * @param begin The number, may overlap with out
+	 * @param length The amount of characters of the number
+	 * @param prefix The amount of leading characters (sign and base) that std::internal pads after
+	 */
+	void commit_padded( char* out, const char* begin, std::size_t length, std::size_t prefix ) {
+		std::size_t field = static_cast< std::size_t >( width() > 0 ? width() : 0 );
+		width( 0 );
+		if ( field <= length ) {
+			std::memmove( out, begin, length );
+			buf.commit( length );
+			return;
+		}
+
+		std::size_t padding = field - length;
+		std::ios_base::fmtflags adjust = flags() & std::ios_base::adjustfield;
+		if ( adjust == std::ios_base::left ) {
+			std::memmove( out, begin, length );
+			std::memset( out + length, fill(), padding );
+		} else if ( adjust == std::ios_base::internal ) {
+			std::memmove( out + prefix + padding, begin + prefix, length - prefix );
+			std::memmove( out, begin, prefix );
+			std::memset( out + prefix, fill(), padding );
+		} else {
+			std::memmove( out + padding, begin, length );
+			std::memset( out, fill(), padding );
+		}
+		buf.commit( field );
+	}
+
+	/**
+	 * @returns The room needed for a number of length characters padded to the field width
+	 */
+	std::size_t padded_size( std::size_t length ) const {
+		return std::max( length, static_cast< std::size_t >( width() > 0 ? width() : 0 ) );
+	}
+
 public:
 	/**
 	 * @brief The constructor
@@ -91,17 +246,220 @@ public:
 	 */
 	logstreambuf( std::streambuf* outbuf )
 		:	std::ostream(&buf),
-			buf( outbuf )
-	{}
+			buf( outbuf ),
+			m_classic_numbers( false )
+	{
+		m_classic_numbers = ( getloc() == std::locale::classic() );
+		register_callback( &logstreambuf::locale_changed, 0 );
+	}
 
 	/**
-	 * @brief Delete all unflushed content from the target stream and flush to nowhere
+	 * @brief The constructor
+	 * @param out A pointer to some sink where all buffered content is written to when flushed
 	 */
-	void clear_buf() {
-		buf.str("");
+	logstreambuf( sink* out )
+		:	std::ostream(&buf),
+			buf( out ),
+			m_classic_numbers( false )
+	{
+		m_classic_numbers = ( getloc() == std::locale::classic() );
+		register_callback( &logstreambuf::locale_changed, 0 );
+	}
+
+	/**
+	 * @brief Insert an integer with std::to_chars straight into the record buffer
+	 * @note Honors std::hex, std::oct, std::showbase, std::showpos, std::uppercase, std::setw, std::setfill and the adjustment like std::num_put does.
+	 * @note Falls back to std::ostream, if a locale other than the classic one is imbued.
+	 */
+	template< typename T >
+	void insert_integer( T value ) {
+		if ( !m_classic_numbers ) {
+			static_cast< std::ostream& >( *this ) << value;
+			return;
+		}
+
+		char text[3 + 3 * sizeof( T )];	// Sign or base and octal digits
+		char* begin = text + 2;
+		std::size_t prefix = 0;
+		std::ios_base::fmtflags format = flags();
+		std::ios_base::fmtflags base = format & std::ios_base::basefield;
+		char* end = nullptr;
+
+		if ( base == std::ios_base::hex || base == std::ios_base::oct ) {
+			typename std::make_unsigned< T >::type bits = static_cast< typename std::make_unsigned< T >::type >( value );
+			end = std::to_chars( begin, text + sizeof( text ), bits, base == std::ios_base::hex ? 16 : 8 ).ptr;
+			if ( base == std::ios_base::hex && ( format & std::ios_base::uppercase ) ) {
+				for ( char* c = begin; c != end; c++ ) {
+					if ( *c >= 'a' ) {
+						*c -= 'a' - 'A';
+					}
+				}
+			}
+			if ( ( format & std::ios_base::showbase ) && bits != 0 ) {
+				if ( base == std::ios_base::hex ) {
+					*--begin = ( format & std::ios_base::uppercase ) ? 'X' : 'x';
+					prefix = 2;
+				}
+				*--begin = '0';	// The octal 0 counts as digit for std::internal
+			}
+		} else {
+			end = std::to_chars( begin, text + sizeof( text ), value ).ptr;
+			if ( value < 0 ) {
+				prefix = 1;
+			} else if ( std::is_signed< T >::value && ( format & std::ios_base::showpos ) ) {
+				*--begin = '+';
+				prefix = 1;
+			}
+		}
+
+		if ( width() == 0 ) {
+			buf.append( begin, end - begin );
+		} else {
+			commit_padded( buf.prepare( padded_size( end - begin ) ), begin, end - begin, prefix );
+		}
+	}
+
+	/**
+	 * @brief Insert a floating point number with std::to_chars straight into the record buffer
+	 * @note Honors std::fixed, std::scientific, std::setprecision, std::showpos, std::uppercase, std::setw, std::setfill and the adjustment like std::num_put does.
+	 * @note Falls back to std::ostream for std::hexfloat, std::showpoint or a locale other than the classic one.
+	 */
+	void insert_floating( double value ) {
+		std::ios_base::fmtflags format = flags();
+		std::ios_base::fmtflags field = format & std::ios_base::floatfield;
+		if ( !m_classic_numbers || field == ( std::ios_base::fixed | std::ios_base::scientific ) || ( format & std::ios_base::showpoint ) ) {
+			static_cast< std::ostream& >( *this ) << value;
+			return;
+		}
+
+		int digits = static_cast< int >( precision() < 0 ? 6 : precision() );
+		std::chars_format style = ( field == std::ios_base::fixed ? std::chars_format::fixed
+		                          : field == std::ios_base::scientific ? std::chars_format::scientific
+		                          : std::chars_format::general );
+		// Fixed notation of the largest double has 309 digits in front of the point
+		std::size_t size = 2 + static_cast< std::size_t >( digits ) + ( style == std::chars_format::fixed ? 310 : 8 );
+		char* out = buf.prepare( padded_size( size ) + 1 );
+		char* begin = out + 1;	// Room for a sign
+		char* end = std::to_chars( begin, out + size + 1, value, style, digits ).ptr;
+		std::size_t prefix = ( *begin == '-' ? 1 : 0 );
+
+		if ( ( format & std::ios_base::showpos ) && *begin != '-' ) {
+			*--begin = '+';
+			prefix = 1;
+		}
+		if ( ( format & std::ios_base::uppercase ) && style != std::chars_format::fixed ) {	// Like %f, which has no uppercase variant
+			for ( char* c = begin; c != end; c++ ) {
+				if ( *c >= 'a' ) {
+					*c -= 'a' - 'A';
+				}
+			}
+		}
+		commit_padded( out, begin, end - begin, prefix );
+	}
+
+	/**
+	 * @brief Insert a bool as true or false with std::boolalpha, otherwise as integer like std::num_put does
+	 */
+	void insert_bool( bool value ) {
+		if ( !m_classic_numbers ) {
+			static_cast< std::ostream& >( *this ) << value;
+		} else if ( flags() & std::ios_base::boolalpha ) {
+			commit_padded( buf.prepare( padded_size( 5 ) ), value ? "true" : "false", value ? 4 : 5, 0 );
+		} else {
+			insert_integer( static_cast< long >( value ) );
+		}
+	}
+
+	/**
+	 * @brief Mark everything buffered so far as prefix of the current record (like timestamp and severity)
+	 */
+	void end_prefix() {
+		buf.end_prefix();
+	}
+
+	/**
+	 * @brief Set the severity that is handed to the sink with the current record
+	 * @param severity The severity as integer
+	 */
+	void set_severity( int severity ) {
+		buf.set_severity( severity );
+	}
+
+	/**
+	 * @returns The severity that is handed to the sink with the current record
+	 */
+	int severity() const {
+		return buf.severity();
+	}
+
+	/**
+	 * @brief Write bytes to the target sink as a record of their own without touching the current record (like binary definitions)
+	 * @param data Pointer to the first byte
+	 * @param size The amount of bytes
+	 */
+	void write_through( const char* data, std::size_t size ) {
+		buf.write_through( data, size );
+	}
+
+	/**
+	 * @returns A pointer to the first byte of the current record
+	 */
+	char* record_data() {
+		return buf.data();
+	}
+
+	/**
+	 * @returns The amount of bytes in the current record
+	 */
+	std::size_t record_size() const {
+		return buf.size();
+	}
+
+	/**
+	 * @brief Terminate the current record with a newline and flush it to the target sink
+	 */
+	void end_record() {
+		buf.terminate();
 		flush();
 	}
 
+	/**
+	 * @brief Insert a sequence of characters directly into the record buffer
+	 * @param characters Pointer to the first character
+	 * @param length The amount of characters to insert
+	 * @note Falls back to formatted output, if a field width was set (like with std::setw)
+	 */
+	void insert( const char* characters, std::size_t length ) {
+		if ( width() != 0 ) {
+			static_cast< std::ostream& >( *this ) << std::string_view( characters, length );
+		} else {
+			buf.append( characters, length );
+		}
+	}
+
+	/**
+	 * @brief Make room for writing characters directly into the record buffer (see record_buffer::prepare)
+	 * @param length The maximal amount of characters that will be written
+	 */
+	char* prepare( std::size_t length ) {
+		return buf.prepare( length );
+	}
+
+	/**
+	 * @brief Add characters written to the pointer returned by prepare to the record
+	 * @param length The amount of characters written
+	 */
+	void commit( std::size_t length ) {
+		buf.commit( length );
+	}
+
+	/**
+	 * @brief Delete all unflushed content without writing it to the target stream
+	 */
+	void clear_buf() {
+		buf.discard();
+	}
+
 	/**
 	 * @brief Get the content of the target stream buffer
 	 * @return The content of the target stream buffer
@@ -115,25 +473,262 @@ public:
 	 * @return True, if content is found; false otherwise
 	 */
 	bool has_buffered_content() {
-		return ( buf.str().length() > 0 );
+		return ( buf.size() > 0 );
 	}
 	
 	/**
-	 * @brief Determines, if the underlying stream is a terminal
-	 * @note Will fail in some cases where a terminal supports positioning
+	 * @brief Determines, if the underlying sink is a terminal
 	 */
 	bool sink_is_terminal() {
 		return buf.sink_is_terminal();
 	}
+
+	/**
+	 * @brief Write all further records to another sink
+	 * @param out The new sink or nullptr to write to the streambuf given on construction again
+	 */
+	void set_sink( sink* out ) {
+		buf.set_sink( out );
+	}
+
+	/**
+	 * @brief Block until all records written so far reached the target of the sink
+	 */
+	void drain() {
+		buf.drain();
+	}
 };
 
 
-inline logstreambuf& operator<<(  logstreambuf& out, const char* characters ) {
-    std::istringstream input( characters );
-    out << input.rdbuf();
-    return out;
+/**
+ * @brief Insert a C-string or a character array into a logstreambuf
+ * @param out A sink of a logger
+ * @param characters A pointer to a null-terminated string or a character array (like a string literal)
+ * @returns A reference to the sink
+ * @note The length of arrays is bounded by their size, so the length of string literals is known at compile time
+ */
+template< typename char_array_t
+        , typename std::enable_if< std::is_same< typename std::decay< char_array_t >::type, const char* >::value
+                                || std::is_same< typename std::decay< char_array_t >::type, char* >::value, int >::type = 0 >
+inline logstreambuf& operator<<( logstreambuf& out, const char_array_t& characters ) {
+	if ( std::is_array< char_array_t >::value ) {
+		const std::size_t size = sizeof( char_array_t );
+		const void* end = std::memchr( characters, '\0', size );
+		out.insert( characters, end != nullptr ? static_cast< std::size_t >( static_cast< const char* >( end ) - characters ) : size );
+	} else if ( characters != nullptr ) {
+		out.insert( characters, std::strlen( characters ) );
+	}
+	return out;
+}
+
+/**
+ * @brief Wether a type is inserted into a logstreambuf by its own numeric path instead of std::num_put
+ */
+template< typename T >
+struct fast_number
+	:	public std::integral_constant< bool
+	                               , std::is_same< T, short >::value || std::is_same< T, unsigned short >::value
+	                              || std::is_same< T, int >::value || std::is_same< T, unsigned int >::value
+	                              || std::is_same< T, long >::value || std::is_same< T, unsigned long >::value
+	                              || std::is_same< T, long long >::value || std::is_same< T, unsigned long long >::value
+	                              || std::is_same< T, float >::value || std::is_same< T, double >::value
+	                              || std::is_same< T, bool >::value >
+{};
+
+/**
+ * @brief Insert a number into a logstreambuf without std::num_put
+ * @param out A sink of a logger
+ * @param value An integer, float, double or bool
+ * @returns A reference to the sink
+ * @note Produces the same text as std::ostream with the manipulators set on out (like std::hex or std::setprecision)
+ */
+template< typename number_t, typename std::enable_if< fast_number< number_t >::value, int >::type = 0 >
+inline logstreambuf& operator<<( logstreambuf& out, number_t value ) {
+	if constexpr ( std::is_same< number_t, bool >::value ) {
+		out.insert_bool( value );
+	} else if constexpr ( std::is_floating_point< number_t >::value ) {
+		out.insert_floating( value );
+	} else {
+		out.insert_integer( value );
+	}
+	return out;
 }
 
+/**
+ * @brief Customization point for writing objects of type T straight into the record buffer
+ * @note Specialize it with a function static void format( logstreambuf& out, const T& value ) that writes with
+ * @note out.insert, out.prepare and out.commit or inserts other values into out.
+ * @note Types without a formatter are inserted with their operator<<( std::ostream&, const T& ).
+ */
+template< typename T, typename enable_t = void >
+struct formatter {};
+
+/**
+ * @brief Wether a formatter is specialized for T
+ */
+template< typename T, typename enable_t = void >
+struct has_formatter
+	:	public std::false_type
+{};
+
+template< typename T >
+struct has_formatter< T, std::void_t< decltype( formatter< T >::format( std::declval< logstreambuf& >(), std::declval< const T& >() ) ) > >
+	:	public std::true_type
+{};
+
+/**
+ * @brief Insert an object that has a formatter into a logstreambuf
+ * @param out A sink of a logger
+ * @param value The object to log
+ * @returns A reference to the sink
+ */
+template< typename T, typename std::enable_if< has_formatter< T >::value, int >::type = 0 >
+inline logstreambuf& operator<<( logstreambuf& out, const T& value ) {
+	formatter< T >::format( out, value );
+	return out;
+}
+
+/**
+ * @brief Inserts a std::string_view without copying it
+ */
+template<>
+struct formatter< std::string_view > {
+	static void format( logstreambuf& out, std::string_view str ) {
+		out.insert( str.data(), str.size() );
+	}
+};
+
+/**
+ * @brief Inserts a std::string without copying it
+ */
+template<>
+struct formatter< std::string > {
+	static void format( logstreambuf& out, const std::string& str ) {
+		out.insert( str.data(), str.size() );
+	}
+};
+
+/**
+ * @brief Encode UTF-16 text as UTF-8. Unpaired surrogates are replaced by U+FFFD.
+ * @param out Room for at least 3 * length bytes
+ * @param text Pointer to the first code unit
+ * @param length The amount of code units
+ * @returns The amount of bytes written
+ */
+inline std::size_t encode_utf16( char* out, const char16_t* text, std::size_t length ) {
+	char* o = out;
+	for ( std::size_t i = 0; i < length; i++ ) {
+		char32_t c = text[i];
+		if ( c < 0x80 ) {
+			*o++ = static_cast< char >( c );
+			continue;
+		}
+		if ( c >= 0xd800 && c < 0xdc00 && i + 1 < length && text[i + 1] >= 0xdc00 && text[i + 1] < 0xe000 ) {
+			c = 0x10000 + ( ( c - 0xd800 ) << 10 ) + ( text[++i] - 0xdc00 );	// 4 bytes for 2 code units
+			*o++ = static_cast< char >( 0xf0 | ( c >> 18 ) );
+			*o++ = static_cast< char >( 0x80 | ( ( c >> 12 ) & 0x3f ) );
+			*o++ = static_cast< char >( 0x80 | ( ( c >> 6 ) & 0x3f ) );
+			*o++ = static_cast< char >( 0x80 | ( c & 0x3f ) );
+			continue;
+		}
+		if ( c >= 0xd800 && c < 0xe000 ) {
+			c = 0xfffd;
+		}
+		if ( c < 0x800 ) {
+			*o++ = static_cast< char >( 0xc0 | ( c >> 6 ) );
+		} else {
+			*o++ = static_cast< char >( 0xe0 | ( c >> 12 ) );
+			*o++ = static_cast< char >( 0x80 | ( ( c >> 6 ) & 0x3f ) );
+		}
+		*o++ = static_cast< char >( 0x80 | ( c & 0x3f ) );
+	}
+	return static_cast< std::size_t >( o - out );
+}
+
+/**
+ * @brief Insert UTF-16 text into a logstreambuf as UTF-8 without converting it to a string first
+ * @param out A sink of a logger
+ * @param text Pointer to the first code unit
+ * @param length The amount of code units
+ */
+inline void insert_utf16( logstreambuf& out, const char16_t* text, std::size_t length ) {
+	if ( out.width() != 0 ) {	// Padding is applied by the std::ostream fallback of insert
+		std::string encoded( 3 * length, '\0' );
+		out.insert( encoded.data(), encode_utf16( &encoded[0], text, length ) );
+		return;
+	}
+	char* begin = out.prepare( 3 * length );
+	out.commit( encode_utf16( begin, text, length ) );
+}
+
+/**
+ * @brief Inserts a std::chrono::duration like std::format does in C++20: the count followed by the unit (like 42ms or 1.5s)
+ * @note Microseconds are written as us to keep records ASCII
+ */
+template< typename rep_t, typename period_t >
+struct formatter< std::chrono::duration< rep_t, period_t > > {
+	static void format( logstreambuf& out, const std::chrono::duration< rep_t, period_t >& duration ) {
+		out << duration.count();
+		typedef typename period_t::type period;
+		if constexpr ( std::is_same< period, std::nano >::value ) {
+			out.insert( "ns", 2 );
+		} else if constexpr ( std::is_same< period, std::micro >::value ) {
+			out.insert( "us", 2 );
+		} else if constexpr ( std::is_same< period, std::milli >::value ) {
+			out.insert( "ms", 2 );
+		} else if constexpr ( std::is_same< period, std::ratio< 1 > >::value ) {
+			out.insert( "s", 1 );
+		} else if constexpr ( std::is_same< period, std::ratio< 60 > >::value ) {
+			out.insert( "min", 3 );
+		} else if constexpr ( std::is_same< period, std::ratio< 3600 > >::value ) {
+			out.insert( "h", 1 );
+		} else if constexpr ( std::is_same< period, std::ratio< 86400 > >::value ) {
+			out.insert( "d", 1 );
+		} else {
+			out.insert( "[", 1 );
+			out << static_cast< long long >( period::num );
+			if constexpr ( period::den != 1 ) {
+				out.insert( "/", 1 );
+				out << static_cast< long long >( period::den );
+			}
+			out.insert( "]s", 2 );
+		}
+	}
+};
+
+/**
+ * @brief Wether pointers to T are inserted as addresses by formatter (character pointers are strings, function pointers are not addresses in std::ostream)
+ */
+template< typename T >
+struct address_pointee
+	:	public std::integral_constant< bool
+	                               , !std::is_function< T >::value && !std::is_volatile< T >::value
+	                              && !std::is_same< typename std::remove_cv< T >::type, char >::value
+	                              && !std::is_same< typename std::remove_cv< T >::type, signed char >::value
+	                              && !std::is_same< typename std::remove_cv< T >::type, unsigned char >::value >
+{};
+
+/**
+ * @brief Inserts a pointer as address like std::ostream does (like 0x7ffd1c2a or 0 for nullptr)
+ */
+template< typename T >
+struct formatter< T*, typename std::enable_if< address_pointee< T >::value >::type > {
+	static void format( logstreambuf& out, T* const& pointer ) {
+		if ( out.width() != 0 ) {
+			static_cast< std::ostream& >( out ) << static_cast< const void* >( pointer );
+			return;
+		}
+		if ( pointer == nullptr ) {
+			out.insert( "0", 1 );
+			return;
+		}
+		char* begin = out.prepare( 2 + 2 * sizeof( void* ) );
+		begin[0] = '0';
+		begin[1] = 'x';
+		char* end = std::to_chars( begin + 2, begin + 2 + 2 * sizeof( void* ), reinterpret_cast< std::uintptr_t >( pointer ), 16 ).ptr;
+		out.commit( static_cast< std::size_t >( end - begin ) );
+	}
+};
 
 } // namespace logcpp
 
@@ -0,0 +1,120 @@
+/**
+ * @file null_record.hpp
+ * @brief A record that discards everything inserted into it
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+	LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+	Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+	Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+	USA
+*/
+
+
+#pragma once
+
+#include "config.hpp"
+
+
+namespace logcpp {
+
+/**
+ * @brief Inserted into a logger instead of a severity that is stripped at compile time (see LOGCPP_MIN_SEVERITY)
+ */
+struct stripped_severity {};
+
+
+/**
+ * @brief A record that discards everything inserted into it until endrec
+ * @note Returned by loggers, when a stripped_severity is inserted. All insertions are empty inline functions, so the compiler removes them.
+ */
+class null_record
+{
+public:
+	/**
+	 * @brief Discard some object
+	 */
+	template< typename T >
+	null_record& operator<<( const T& ) {
+		return *this;
+	}
+
+	/**
+	 * @brief Insert some function (like endrec) into this null_record
+	 * @param f A function getting a null_record and returning a null_record
+	 */
+	null_record& operator<<( null_record& (*f)( null_record& ) ) {
+		return f( *this );
+	}
+
+	/**
+	 * @brief Does nothing. Provided for endrec.
+	 */
+	void end_record() {}
+
+	/**
+	 * @brief Does nothing. Provided for endl.
+	 */
+	void end_line() {}
+};
+
+
+/**
+ * @brief Selects a severity, if it is compiled in, or a stripped_severity
+ * @note compiled: Wether the severity is at least as critical as LOGCPP_MIN_SEVERITY
+ */
+template< bool compiled >
+struct severity_strip {
+	static const bool enabled = true;
+
+	/**
+	 * @returns The severity returned by f, which is a constant expression, if f is constexpr
+	 */
+	template< typename F >
+	static constexpr auto select( F f ) -> decltype( f() ) {
+		return f();
+	}
+
+	/**
+	 * @returns The severity returned by f
+	 * @param function The name of the function of the statement, passed on to f
+	 */
+	template< typename F >
+	static auto select( const char* function, F f ) -> decltype( f( function ) ) {
+		return f( function );
+	}
+};
+
+/**
+ * @brief Specialization for severities stripped at compile time. Never calls f.
+ */
+template<>
+struct severity_strip< false > {
+	static const bool enabled = false;
+
+	template< typename F >
+	static constexpr stripped_severity select( F ) {
+		return stripped_severity();
+	}
+
+	template< typename F >
+	static stripped_severity select( const char*, F ) {
+		return stripped_severity();
+	}
+};
+
+} // namespace logcpp
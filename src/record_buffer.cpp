@@ -0,0 +1,172 @@
+/**
+ * @file record_buffer.cpp
+ * @brief A fixed-capacity record buffer with an inline region and pooled spill blocks
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+    LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+    Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+    Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 3 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+    USA
+*/
+
+
+#include "record_buffer.hpp"
+
+#include <mutex>
+#include <vector>
+
+
+namespace logcpp {
+
+namespace {
+
+/**
+ * @brief Amount of size classes between block_pool::min_block_size and block_pool::max_cached_block_size
+ */
+const std::size_t size_classes = 9;
+
+/**
+ * @brief Maximum amount of free blocks kept per size class
+ */
+const std::size_t max_free_blocks = 16;
+
+struct pool_state {
+    std::mutex lock;
+    std::vector< char* > free_blocks[size_classes];
+};
+
+/**
+ * @brief The pool is never destroyed, so loggers with static storage duration may release blocks on exit
+ */
+pool_state& pool() {
+    static pool_state* state = new pool_state();
+    return *state;
+}
+
+std::size_t size_class( std::size_t block_size ) {
+    std::size_t cls = 0;
+    while ( (block_pool::min_block_size << cls) < block_size ) {
+        cls++;
+    }
+    return cls;
+}
+
+} // namespace
+
+
+
+char* block_pool::acquire( std::size_t size, std::size_t& block_size ) {
+    block_size = min_block_size;
+    while ( block_size < size ) {
+        block_size <<= 1;
+    }
+
+    if ( block_size <= max_cached_block_size ) {
+        pool_state& state = pool();
+        std::lock_guard< std::mutex > guard( state.lock );
+        std::vector< char* >& blocks = state.free_blocks[size_class( block_size )];
+        if ( !blocks.empty() ) {
+            char* block = blocks.back();
+            blocks.pop_back();
+            return block;
+        }
+    }
+
+    return new char[block_size];
+}
+
+
+void block_pool::release( char* block, std::size_t block_size ) {
+    if ( block_size <= max_cached_block_size ) {
+        pool_state& state = pool();
+        std::lock_guard< std::mutex > guard( state.lock );
+        std::vector< char* >& blocks = state.free_blocks[size_class( block_size )];
+        if ( blocks.size() < max_free_blocks ) {
+            blocks.push_back( block );
+            return;
+        }
+    }
+
+    delete[] block;
+}
+
+
+
+
+record_buffer::record_buffer()
+    :   std::streambuf()
+    ,   m_block( nullptr )
+    ,   m_block_size( 0 )
+{
+    setp( m_inline, m_inline + inline_capacity );
+}
+
+
+record_buffer::~record_buffer() {
+    if ( m_block != nullptr ) {
+        block_pool::release( m_block, m_block_size );
+    }
+}
+
+
+void record_buffer::grow( std::size_t needed ) {
+    std::size_t used = size();
+    std::size_t new_size = 0;
+    char* block = block_pool::acquire( used + needed, new_size );
+
+    std::memcpy( block, pbase(), used );
+
+    if ( m_block != nullptr ) {
+        block_pool::release( m_block, m_block_size );
+    }
+    m_block = block;
+    m_block_size = new_size;
+
+    setp( m_block, m_block + m_block_size );
+    pbump( static_cast< int >( used ) );
+}
+
+
+record_buffer::int_type record_buffer::overflow( int_type ch ) {
+    if ( traits_type::eq_int_type( ch, traits_type::eof() ) ) {
+        return traits_type::not_eof( ch );
+    }
+
+    char c = traits_type::to_char_type( ch );
+    append( &c, 1 );
+    return ch;
+}
+
+
+std::streamsize record_buffer::xsputn( const char* s, std::streamsize n ) {
+    append( s, static_cast< std::size_t >( n ) );
+    return n;
+}
+
+
+void record_buffer::reset() {
+    if ( m_block != nullptr ) {
+        block_pool::release( m_block, m_block_size );
+        m_block = nullptr;
+        m_block_size = 0;
+    }
+    setp( m_inline, m_inline + inline_capacity );
+}
+
+
+} // namespace logcpp
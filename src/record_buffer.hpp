@@ -0,0 +1,172 @@
+/**
+ * @file record_buffer.hpp
+ * @brief A fixed-capacity record buffer with an inline region and pooled spill blocks
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+	LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+	Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+	Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+	USA
+*/
+
+
+#pragma once
+
+#include "config.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <streambuf>
+#include <string>
+
+
+/**
+ * @def LOGCPP_RECORD_INLINE_SIZE
+ * @brief Amount of bytes a record can hold before it spills to a pooled block
+ */
+#ifndef LOGCPP_RECORD_INLINE_SIZE
+#define LOGCPP_RECORD_INLINE_SIZE 512
+#endif
+
+
+namespace logcpp {
+
+/**
+ * @brief A process-wide pool of spill blocks for records that do not fit into their inline region
+ * @note Blocks are handed out in power of two size classes and kept for reuse when released
+ */
+class block_pool {
+public:
+	/**
+	 * @brief The size of the smallest block handed out
+	 */
+	static const std::size_t min_block_size = 4096;
+	/**
+	 * @brief Blocks larger than this are not cached, but freed on release
+	 */
+	static const std::size_t max_cached_block_size = 1024 * 1024;
+
+	/**
+	 * @brief Get a block that can hold at least size bytes
+	 * @param size The minimal amount of bytes needed
+	 * @param block_size Receives the real size of the block returned
+	 * @returns A pointer to the block
+	 */
+	static char* acquire( std::size_t size, std::size_t& block_size );
+
+	/**
+	 * @brief Give a block back to the pool
+	 * @param block The block to release as returned by acquire
+	 * @param block_size The size of the block as returned by acquire
+	 */
+	static void release( char* block, std::size_t block_size );
+};
+
+
+/**
+ * @brief A stream buffer that holds one record in an inline region and spills to a pooled block when it grows larger
+ */
+class record_buffer
+	:	public std::streambuf
+{
+public:
+	/**
+	 * @brief The amount of bytes that can be buffered without touching the block pool
+	 */
+	static const std::size_t inline_capacity = LOGCPP_RECORD_INLINE_SIZE;
+
+private:
+	char m_inline[inline_capacity];
+	char* m_block;
+	std::size_t m_block_size;
+
+	void grow( std::size_t needed );
+
+protected:
+	virtual int_type overflow( int_type ch );
+	virtual std::streamsize xsputn( const char* s, std::streamsize n );
+
+public:
+	/**
+	 * @brief Constructor
+	 */
+	record_buffer();
+	record_buffer( const record_buffer& ) = delete;
+	virtual ~record_buffer();
+
+	/**
+	 * @brief Append bytes to the record without going through the std::streambuf interface
+	 * @param s Pointer to the bytes to append
+	 * @param n The amount of bytes to append
+	 */
+	void append( const char* s, std::size_t n ) {
+		if ( n > static_cast< std::size_t >( epptr() - pptr() ) ) {
+			grow( n );
+		}
+		std::memcpy( pptr(), s, n );
+		pbump( static_cast< int >( n ) );
+	}
+
+	/**
+	 * @brief Make room for writing bytes to the end of the record in place
+	 * @param n The maximal amount of bytes that will be written
+	 * @returns A pointer to write to. Call commit with the amount of bytes written afterwards.
+	 */
+	char* prepare( std::size_t n ) {
+		if ( n > static_cast< std::size_t >( epptr() - pptr() ) ) {
+			grow( n );
+		}
+		return pptr();
+	}
+
+	/**
+	 * @brief Add bytes written to the pointer returned by prepare to the record
+	 * @param n The amount of bytes written
+	 */
+	void commit( std::size_t n ) {
+		pbump( static_cast< int >( n ) );
+	}
+
+	/**
+	 * @returns A pointer to the first byte of the record
+	 */
+	const char* data() const { return pbase(); }
+
+	/**
+	 * @returns A pointer to the first byte of the record, e.g. to fill in fields after writing them
+	 */
+	char* data() { return pbase(); }
+
+	/**
+	 * @returns The amount of bytes currently buffered
+	 */
+	std::size_t size() const { return static_cast< std::size_t >( pptr() - pbase() ); }
+
+	/**
+	 * @returns A copy of the buffered content
+	 */
+	std::string str() const { return std::string( data(), size() ); }
+
+	/**
+	 * @brief Drop all buffered content and give a spilled block back to the pool
+	 */
+	void reset();
+};
+
+
+} // namespace logcpp
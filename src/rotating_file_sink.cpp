@@ -0,0 +1,412 @@
+/**
+ * @file rotating_file_sink.cpp
+ * @brief A file sink that rolls over to a new file by size or time and compresses closed segments in the background
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+    LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+    Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+    Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 3 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+    USA
+*/
+
+
+#include "rotating_file_sink.hpp"
+
+#ifdef __unix__
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <ctime>
+#include <utility>
+#include <vector>
+
+extern "C" {
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+}
+
+#ifdef LOGCPP_ENABLE_ZLIB
+#include <zlib.h>
+#endif
+
+
+namespace logcpp {
+
+namespace {
+
+/**
+ * @brief Length of the time stamp in the name of a segment like 20261017-134501
+ */
+const std::size_t stamp_size = 15;
+
+/**
+ * @brief Check, if a directory entry is a closed segment of a file
+ * @param name The name of the directory entry
+ * @param base The name of the file without directory
+ * @param key Set to the name without .gz, which sorts segments from old to new
+ * @param compressed Set to wether the segment is compressed
+ */
+bool parse_segment( const std::string& name, const std::string& base, std::string& key, bool& compressed ) {
+    const std::size_t pos = base.size() + 1;
+    if ( name.size() <= pos || name.compare( 0, base.size(), base ) != 0 || name[base.size()] != '.' ) {
+        return false;
+    }
+    key = name;
+    compressed = ( key.size() > 3 && key.compare( key.size() - 3, 3, ".gz" ) == 0 );
+    if ( compressed ) {
+        key.resize( key.size() - 3 );
+    }
+    if ( key.size() != pos + stamp_size && key.size() != pos + stamp_size + 5 ) {
+        return false;
+    }
+    for ( std::size_t i = pos; i < key.size(); i++ ) {
+        const std::size_t offset = i - pos;
+        const char expected = ( offset == 8 ? '-' : ( offset == stamp_size ? '.' : '0' ) );
+        if ( expected == '0' ? ( key[i] < '0' || key[i] > '9' ) : key[i] != expected ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Wait until the data of a closed file is stored durably
+ */
+void sync_file( const std::string& path ) {
+    int fd = ::open( path.c_str(), O_RDONLY | O_CLOEXEC );
+    if ( fd < 0 ) {
+        return;
+    }
+#ifdef __linux__
+    while ( ::fdatasync( fd ) != 0 && errno == EINTR ) {}
+#else
+    while ( ::fsync( fd ) != 0 && errno == EINTR ) {}
+#endif
+    ::close( fd );
+}
+
+/**
+ * @brief Compress a closed segment to segment.gz and remove it afterwards
+ * @param sync Wether the .gz is synced before it replaces the segment
+ * @returns False, if the segment is left as it is
+ */
+bool compress_segment( const std::string& segment, bool sync ) {
+#ifdef LOGCPP_ENABLE_ZLIB
+    int in = ::open( segment.c_str(), O_RDONLY | O_CLOEXEC );
+    if ( in < 0 ) {
+        return false;
+    }
+    const std::string temporary = segment + ".gz.tmp";
+    gzFile out = gzopen( temporary.c_str(), "wb" );
+    if ( out == nullptr ) {
+        ::close( in );
+        return false;
+    }
+
+    std::vector< char > buffer( 64 * 1024 );
+    bool ok = true;
+    for (;;) {
+        ssize_t got = ::read( in, buffer.data(), buffer.size() );
+        if ( got < 0 ) {
+            if ( errno == EINTR ) {
+                continue;
+            }
+            ok = false;
+            break;
+        }
+        if ( got == 0 ) {
+            break;
+        }
+        if ( gzwrite( out, buffer.data(), static_cast< unsigned int >( got ) ) != static_cast< int >( got ) ) {
+            ok = false;
+            break;
+        }
+    }
+    ::close( in );
+    if ( gzclose( out ) != Z_OK ) {
+        ok = false;
+    }
+    if ( ok && sync ) {
+        sync_file( temporary );
+    }
+
+    if ( ok && ::rename( temporary.c_str(), ( segment + ".gz" ).c_str() ) == 0 ) {
+        ::unlink( segment.c_str() );
+        return true;
+    }
+    ::unlink( temporary.c_str() );
+    return false;
+#else
+    (void)segment;
+    (void)sync;
+    return false;
+#endif
+}
+
+} // namespace
+
+
+rotating_file_sink::rotating_file_sink( const std::string& path, const rotation_policy& policy, std::size_t buffer_size )
+    :   fd_sink( -1, true, buffer_size )
+    ,   m_path( path )
+    ,   m_directory( "." )
+    ,   m_base( path )
+    ,   m_policy( policy )
+    ,   m_size( 0 )
+    ,   m_next_boundary( 0 )
+    ,   m_last_stamp()
+    ,   m_stamp_count( 0 )
+    ,   m_durable( false )
+    ,   m_lock()
+    ,   m_wakeup()
+    ,   m_jobs()
+    ,   m_stop( false )
+    ,   m_worker()
+{
+    const std::size_t slash = path.find_last_of( '/' );
+    if ( slash != std::string::npos ) {
+        m_directory = ( slash == 0 ? std::string( "/" ) : path.substr( 0, slash ) );
+        m_base = path.substr( slash + 1 );
+    }
+    open_file();
+
+    if ( m_policy.interval.count() > 0 ) {
+        const std::int64_t now = static_cast< std::int64_t >( ::time( nullptr ) );
+        m_next_boundary = next_boundary( now );
+
+        struct stat info;
+        const std::int64_t period_start = m_next_boundary - m_policy.interval.count();
+        if ( m_size > 0 && ::fstat( m_fd, &info ) == 0 && static_cast< std::int64_t >( info.st_mtime ) < period_start ) {
+            rotate();   // The file was written in an earlier period
+        }
+    }
+    schedule_leftovers();
+}
+
+
+rotating_file_sink::~rotating_file_sink() {
+    flush();
+    {
+        std::lock_guard< std::mutex > guard( m_lock );
+        m_stop = true;
+    }
+    m_wakeup.notify_one();
+    if ( m_worker.joinable() ) {
+        m_worker.join();
+    }
+}
+
+
+void rotating_file_sink::open_file() {
+    m_fd = ::open( m_path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644 );
+    m_size = 0;
+
+    struct stat info;
+    if ( m_fd >= 0 && ::fstat( m_fd, &info ) == 0 ) {
+        m_size = static_cast< std::size_t >( info.st_size );
+    }
+}
+
+
+std::int64_t rotating_file_sink::next_boundary( std::int64_t now ) const {
+    const std::int64_t interval = m_policy.interval.count();
+    return ( now / interval + 1 ) * interval;
+}
+
+
+std::string rotating_file_sink::segment_name() {
+    char stamp[32];
+    std::time_t now = ::time( nullptr );
+    struct tm utc;
+    ::gmtime_r( &now, &utc );
+    std::strftime( stamp, sizeof( stamp ), "%Y%m%d-%H%M%S", &utc );
+
+    if ( m_last_stamp == stamp ) {
+        m_stamp_count++;
+    } else {
+        m_last_stamp = stamp;
+        m_stamp_count = 0;
+    }
+
+    for (;;) {
+        std::string name = m_path + "." + stamp;
+        if ( m_stamp_count > 0 ) {
+            char counter[8];
+            std::snprintf( counter, sizeof( counter ), ".%04u", m_stamp_count % 10000 );
+            name += counter;
+        }
+        if ( ::access( name.c_str(), F_OK ) != 0 && ::access( ( name + ".gz" ).c_str(), F_OK ) != 0 ) {
+            return name;
+        }
+        m_stamp_count++;
+    }
+}
+
+
+void rotating_file_sink::rotate() {
+    flush();    // A durable segment is synced by the background thread
+    if ( m_fd >= 0 ) {
+        ::close( m_fd );
+        m_fd = -1;
+    }
+
+    const std::string segment = segment_name();
+    if ( ::rename( m_path.c_str(), segment.c_str() ) == 0 ) {
+        schedule( segment, m_durable );
+    }   // Otherwise keep appending to the same file
+    open_file();
+}
+
+
+void rotating_file_sink::write( const record_view& record ) {
+    const std::size_t total = record.prefix_size + record.body_size + ( record.terminated ? 1 : 0 );
+
+    if ( m_next_boundary > 0 ) {
+        const std::int64_t now = static_cast< std::int64_t >( ::time( nullptr ) );
+        if ( now >= m_next_boundary ) {
+            m_next_boundary = next_boundary( now );
+            if ( m_size > 0 ) {
+                rotate();
+            }
+        }
+    }
+    if ( m_policy.max_size > 0 && m_size > 0 && m_size + total > m_policy.max_size ) {
+        rotate();
+    }
+
+    fd_sink::write( record );
+    m_size += total;
+}
+
+
+void rotating_file_sink::sync() {
+    m_durable = true;
+    fd_sink::sync();
+}
+
+
+void rotating_file_sink::schedule( const std::string& segment, bool sync ) {
+    {
+        std::lock_guard< std::mutex > guard( m_lock );
+        m_jobs.push_back( job{ segment, sync } );
+        if ( !m_worker.joinable() ) {
+            m_worker = std::thread( &rotating_file_sink::run, this );
+        }
+    }
+    m_wakeup.notify_one();
+}
+
+
+void rotating_file_sink::schedule_leftovers() {
+    std::vector< std::string > leftovers;
+
+    if ( m_policy.compress && compression_supported() ) {
+        DIR* directory = ::opendir( m_directory.c_str() );
+        if ( directory != nullptr ) {
+            std::string key;
+            bool compressed = false;
+            while ( struct dirent* entry = ::readdir( directory ) ) {
+                if ( parse_segment( entry->d_name, m_base, key, compressed ) && !compressed ) {
+                    leftovers.push_back( m_directory + "/" + entry->d_name );
+                }
+            }
+            ::closedir( directory );
+        }
+    }
+    std::sort( leftovers.begin(), leftovers.end() );
+
+    for ( const std::string& segment : leftovers ) {
+        schedule( segment );
+    }
+    if ( leftovers.empty() && m_policy.max_segments > 0 ) {
+        schedule( std::string() );
+    }
+}
+
+
+void rotating_file_sink::prune() {
+    if ( m_policy.max_segments == 0 ) {
+        return;
+    }
+    DIR* directory = ::opendir( m_directory.c_str() );
+    if ( directory == nullptr ) {
+        return;
+    }
+
+    std::vector< std::pair< std::string, std::string > > segments;  // The key to sort by and the name
+    std::string key;
+    bool compressed = false;
+    while ( struct dirent* entry = ::readdir( directory ) ) {
+        if ( parse_segment( entry->d_name, m_base, key, compressed ) ) {
+            segments.emplace_back( key, entry->d_name );
+        }
+    }
+    ::closedir( directory );
+
+    if ( segments.size() <= m_policy.max_segments ) {
+        return;
+    }
+    std::sort( segments.begin(), segments.end() );
+    const std::size_t excess = segments.size() - m_policy.max_segments;
+    for ( std::size_t i = 0; i < excess; i++ ) {
+        ::unlink( ( m_directory + "/" + segments[i].second ).c_str() );
+    }
+}
+
+
+void rotating_file_sink::run() {
+    std::unique_lock< std::mutex > lock( m_lock );
+    for (;;) {
+        while ( m_jobs.empty() && !m_stop ) {
+            m_wakeup.wait( lock );
+        }
+        if ( m_jobs.empty() ) {
+            return;
+        }
+        const job next = std::move( m_jobs.front() );
+        m_jobs.pop_front();
+        lock.unlock();
+
+        if ( !next.segment.empty() && next.sync ) {
+            sync_file( next.segment );
+        }
+        if ( !next.segment.empty() && m_policy.compress ) {
+            compress_segment( next.segment, next.sync );
+        }
+        prune();
+
+        lock.lock();
+    }
+}
+
+
+bool rotating_file_sink::compression_supported() {
+#ifdef LOGCPP_ENABLE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+} // namespace logcpp
+
+#endif
@@ -0,0 +1,217 @@
+/**
+ * @file rotating_file_sink.hpp
+ * @brief A file sink that rolls over to a new file by size or time and compresses closed segments in the background
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+	LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+	Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+	Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+	USA
+*/
+
+
+#pragma once
+
+#include "config.hpp"
+
+#include "fd_sink.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+
+namespace logcpp {
+
+/**
+ * @brief When a rotating_file_sink rolls over and how many closed segments it keeps
+ */
+struct rotation_policy {
+	/**
+	 * @brief Roll over before a record would make the file larger than this amount of bytes. Zero disables rotation by size.
+	 */
+	std::size_t max_size;
+	/**
+	 * @brief Roll over at each multiple of this interval since the epoch (UTC), like every full hour. Zero disables rotation by time.
+	 */
+	std::chrono::seconds interval;
+	/**
+	 * @brief The amount of closed segments kept. Older ones are deleted. Zero keeps all.
+	 */
+	std::size_t max_segments;
+	/**
+	 * @brief Wether closed segments are compressed with gzip (needs liblogcpp built with zlib)
+	 */
+	bool compress;
+
+	/**
+	 * @brief Constructor
+	 * @param max_size The size in bytes to roll over at (0 for no limit)
+	 * @param interval The interval to roll over at (0 for no limit)
+	 * @param max_segments The amount of closed segments to keep (0 for all)
+	 * @param compress Wether to compress closed segments
+	 */
+	explicit rotation_policy( std::size_t max_size = 0, std::chrono::seconds interval = std::chrono::seconds( 0 ), std::size_t max_segments = 0, bool compress = true )
+		:	max_size( max_size )
+		,	interval( interval )
+		,	max_segments( max_segments )
+		,	compress( compress )
+	{}
+
+	/**
+	 * @returns Wether the policy rolls over at all
+	 */
+	bool enabled() const { return ( max_size > 0 || interval.count() > 0 ); }
+};
+
+
+#ifdef __unix__
+
+/**
+ * @brief A fd_sink appending to a file that is renamed to a closed segment, when it reaches a size or a time boundary
+ * @note Closed segments are named like path.20261017-134501 (UTC time of the rollover, like the interval boundaries) and get a counter like .0001, if the name is taken.
+ * @note Rolling over flushes, renames and reopens the file on the writing thread. A background thread compresses closed segments to .gz and deletes segments beyond the retention count.
+ * @note After sync was called, the background thread also syncs each closed segment (and its .gz) before it is compressed, so the writing thread never waits for the disk.
+ * @note Segments left uncompressed by an earlier run are compressed after construction.
+ */
+class rotating_file_sink
+	:	public fd_sink
+{
+protected:
+	std::string m_path;
+	std::string m_directory;
+	std::string m_base;
+	rotation_policy m_policy;
+	std::size_t m_size;
+	/**
+	 * @brief The next time boundary as seconds since the epoch or zero, if rotation by time is disabled
+	 */
+	std::int64_t m_next_boundary;
+	std::string m_last_stamp;
+	unsigned int m_stamp_count;
+	/**
+	 * @brief Wether sync was called, so that closed segments are synced by the background thread as well
+	 */
+	bool m_durable;
+
+	/**
+	 * @brief A closed segment handed to the background thread
+	 */
+	struct job {
+		/**
+		 * @brief The path of the segment or empty for nothing but pruning
+		 */
+		std::string segment;
+		/**
+		 * @brief Wether the segment is synced before it is compressed
+		 */
+		bool sync;
+	};
+
+	std::mutex m_lock;
+	std::condition_variable m_wakeup;
+	std::deque< job > m_jobs;
+	bool m_stop;
+	std::thread m_worker;
+
+	/**
+	 * @brief Close the current file, rename it to a closed segment and open a new one
+	 */
+	void rotate();
+
+	/**
+	 * @brief Open the file at m_path and read its current size
+	 */
+	void open_file();
+
+	/**
+	 * @returns The first time boundary after a point in time (seconds since the epoch)
+	 */
+	std::int64_t next_boundary( std::int64_t now ) const;
+
+	/**
+	 * @returns A name for the next closed segment that is not taken yet
+	 */
+	std::string segment_name();
+
+	/**
+	 * @brief Hand a closed segment (or nothing but pruning for an empty path) to the background thread
+	 * @param sync Wether the background thread syncs the segment first
+	 */
+	void schedule( const std::string& segment, bool sync = false );
+
+	/**
+	 * @brief Queue all uncompressed segments left by an earlier run and prune old ones
+	 */
+	void schedule_leftovers();
+
+	/**
+	 * @brief Delete the oldest closed segments beyond the retention count
+	 */
+	void prune();
+
+	/**
+	 * @brief The loop of the background thread
+	 */
+	void run();
+
+public:
+	/**
+	 * @brief Constructor. Appends to the file, which is created if it does not exist.
+	 * @param path The path of the file to log to
+	 * @param policy When to roll over and how many closed segments to keep
+	 * @param buffer_size The amount of bytes buffered before writing
+	 */
+	rotating_file_sink( const std::string& path, const rotation_policy& policy, std::size_t buffer_size = default_buffer_size );
+
+	rotating_file_sink( const rotating_file_sink& ) = delete;
+
+	/**
+	 * @brief Destructor. Flushes the file and waits for the background thread to compress the segments closed so far.
+	 */
+	virtual ~rotating_file_sink();
+
+	/**
+	 * @brief Write a record. Rolls over first, if the record crosses the size limit or a time boundary passed.
+	 */
+	virtual void write( const record_view& record );
+
+	/**
+	 * @brief Flush and sync the current file. From now on closed segments are synced by the background thread as well.
+	 */
+	virtual void sync();
+
+	/**
+	 * @returns The amount of bytes in the current file
+	 */
+	std::size_t size() const { return m_size; }
+
+	/**
+	 * @returns Wether liblogcpp was built with zlib and compresses closed segments
+	 */
+	static bool compression_supported();
+};
+
+#endif
+
+
+} // namespace logcpp
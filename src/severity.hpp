@@ -29,61 +29,272 @@
 
 #include "config.hpp"
 
-#include <string>
 #include <array>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
 
 
 namespace logcpp {
 
+/**
+ * @brief The name of a severity and the terminal codes its prefix is colored with (empty for no color), see StaticSeverity
+ */
+struct severity_definition {
+	std::string_view name;
+	std::string_view color;
+};
+
+/**
+ * @brief The terminal code that ends a colored prefix
+ */
+constexpr std::string_view severity_color_reset = "\x1b[0m";
+
+/**
+ * @returns The amount of characters of the longest name, skipping the last definition (SIZE_T)
+ */
+constexpr std::size_t max_severity_name_length( const severity_definition* definitions, std::size_t count ) {
+	std::size_t length = 0;
+	for ( std::size_t i = 0; i + 1 < count; i++ ) {
+		if ( definitions[i].name.size() > length ) {
+			length = definitions[i].name.size();
+		}
+	}
+	return length;
+}
+
+/**
+ * @returns The amount of characters of the prefix of definition, see render_severity_prefix
+ */
+constexpr std::size_t severity_prefix_length( const severity_definition& definition, std::size_t max_name_length, bool colored ) {
+	std::size_t length = ( definition.name.size() < max_name_length ? max_name_length : definition.name.size() ) + 4;
+	if ( colored && !definition.color.empty() ) {
+		length += definition.color.size() + severity_color_reset.size();
+	}
+	return length;
+}
+
+/**
+ * @brief Write the prefix of definition like "   <debug>: " aligned to max_name_length to out
+ * @param colored Wether the prefix is enclosed by the color of definition
+ * @returns The amount of characters written
+ */
+constexpr std::size_t render_severity_prefix( char* out, const severity_definition& definition, std::size_t max_name_length, bool colored ) {
+	std::size_t pos = 0;
+	const bool enclosed = colored && !definition.color.empty();
+	for ( std::size_t i = 0; enclosed && i < definition.color.size(); i++ ) {
+		out[pos++] = definition.color[i];
+	}
+	for ( std::size_t i = definition.name.size(); i < max_name_length; i++ ) {
+		out[pos++] = ' ';
+	}
+	out[pos++] = '<';
+	for ( std::size_t i = 0; i < definition.name.size(); i++ ) {
+		out[pos++] = definition.name[i];
+	}
+	out[pos++] = '>';
+	out[pos++] = ':';
+	out[pos++] = ' ';
+	for ( std::size_t i = 0; enclosed && i < severity_color_reset.size(); i++ ) {
+		out[pos++] = severity_color_reset[i];
+	}
+	return pos;
+}
+
+/**
+ * @returns The amount of characters of all plain and colored prefixes of definitions
+ */
+constexpr std::size_t severity_prefix_text_size( const severity_definition* definitions, std::size_t count ) {
+	const std::size_t max_name_length = max_severity_name_length( definitions, count );
+	std::size_t size = 0;
+	for ( std::size_t i = 0; i < count; i++ ) {
+		size += severity_prefix_length( definitions[i], max_name_length, false ) + severity_prefix_length( definitions[i], max_name_length, true );
+	}
+	return size;
+}
+
+/**
+ * @returns The plain and the colored prefix of each definition, one after another
+ */
+template< std::size_t size >
+constexpr std::array< char, size > severity_prefix_text( const severity_definition* definitions, std::size_t count ) {
+	const std::size_t max_name_length = max_severity_name_length( definitions, count );
+	std::array< char, size > text{};
+	std::size_t pos = 0;
+	for ( std::size_t i = 0; i < count; i++ ) {
+		pos += render_severity_prefix( &text[pos], definitions[i], max_name_length, false );
+		pos += render_severity_prefix( &text[pos], definitions[i], max_name_length, true );
+	}
+	return text;
+}
+
+/**
+ * @returns Views of the plain or colored prefixes in text (see severity_prefix_text), indexed by severity
+ */
+template< std::size_t count >
+constexpr std::array< std::string_view, count > severity_prefix_views( const char* text, const severity_definition* definitions, bool colored ) {
+	const std::size_t max_name_length = max_severity_name_length( definitions, count );
+	std::array< std::string_view, count > views{};
+	std::size_t pos = 0;
+	for ( std::size_t i = 0; i < count; i++ ) {
+		const std::size_t plain = severity_prefix_length( definitions[i], max_name_length, false );
+		const std::size_t enclosed = severity_prefix_length( definitions[i], max_name_length, true );
+		views[i] = colored ? std::string_view( text + pos + plain, enclosed ) : std::string_view( text + pos, plain );
+		pos += plain + enclosed;
+	}
+	return views;
+}
+
+
 /**
  * @brief Abstract description of a set of severities
+ * @note The names and the prefixes like "   <debug>: " that start a record are kept in tables, see StaticSeverity
  */
 template< typename severity_t >
 class AbstractSeverity {
+	static constexpr std::size_t size = 1 + (int)severity_t::SEVERITY_SIZE;
+
+	/**
+	 * @brief Tables rendered at runtime for severity sets that are given as strings
+	 */
+	struct rendered_tables {
+		std::array< severity_definition, size > definitions;
+		std::array< std::string, size > text;
+		std::array< std::string_view, size > prefixes;
+	};
 
-	const std::array< const std::string, 1 + (int)severity_t::SEVERITY_SIZE >* m_names;
+	const severity_definition* m_definitions;
+	const std::string_view* m_prefixes;
+	const std::string_view* m_colored_prefixes;
 	unsigned int m_max_name_length;
+	std::unique_ptr< rendered_tables > m_rendered;
+
+	/**
+	 * @returns The index of lvl in the tables. Values out of range map to the last element.
+	 */
+	static constexpr std::size_t index( const severity_t lvl ) {
+		return static_cast< std::size_t >( lvl ) < size ? static_cast< std::size_t >( lvl ) : size - 1;
+	}
 
 protected:
+	/**
+	 * @brief Constructor for tables built at compile time, see StaticSeverity
+	 * @param definitions The name and color of each severity
+	 * @param prefixes The prefix of each severity
+	 * @param colored_prefixes The prefix of each severity enclosed by its color
+	 * @param max_name_length The amount of characters of the longest name
+	 */
+	constexpr AbstractSeverity( const severity_definition* definitions
+	                          , const std::string_view* prefixes
+	                          , const std::string_view* colored_prefixes
+	                          , unsigned int max_name_length )
+		:	m_definitions( definitions )
+		,	m_prefixes( prefixes )
+		,	m_colored_prefixes( colored_prefixes )
+		,	m_max_name_length( max_name_length )
+		,	m_rendered()
+	{}
+
 	/**
 	 * @brief Constructor
-	 * @param severity_names A pointer to an array of names that describe the enum of severity_t
+	 * @param severity_names A pointer to an array of names that describe the enum of severity_t. It has to outlive this object.
+	 * @note Renders the tables on the heap. Prefer StaticSeverity, which needs no allocation.
 	 */
-	AbstractSeverity( const std::array< const std::string, 1 + (int)severity_t::SEVERITY_SIZE >* severity_names )
-		:	m_names( severity_names )
+	AbstractSeverity( const std::array< const std::string, size >* severity_names )
+		:	m_definitions( nullptr )
+		,	m_prefixes( nullptr )
+		,	m_colored_prefixes( nullptr )
 		,	m_max_name_length( 0 )
-	{}
+		,	m_rendered( new rendered_tables() )
+	{
+		for ( std::size_t i = 0; i < size; i++ ) {
+			m_rendered->definitions[i].name = severity_names != nullptr ? std::string_view( (*severity_names)[i] ) : std::string_view( "NULL" );
+		}
+		m_max_name_length = max_severity_name_length( m_rendered->definitions.data(), size );
+		for ( std::size_t i = 0; i < size; i++ ) {
+			std::string& text = m_rendered->text[i];
+			text.resize( severity_prefix_length( m_rendered->definitions[i], m_max_name_length, false ) );
+			render_severity_prefix( &text[0], m_rendered->definitions[i], m_max_name_length, false );
+			m_rendered->prefixes[i] = text;
+		}
+		m_definitions = m_rendered->definitions.data();
+		m_prefixes = m_rendered->prefixes.data();
+		m_colored_prefixes = m_prefixes;
+	}
 
 public:
+	AbstractSeverity( const AbstractSeverity& ) = delete;
+
 	/**
 	 * @return The name for severity_level as string
 	 * @param lvl A severity_level to get as string
 	 */
-	const std::string severity_name( const severity_t lvl ) const {
-		if( this->m_names == 0 ) {
-			return std::string("NULL");
-		} else if( static_cast< std::size_t >(lvl) < this->m_names->size() ) {
-			return this->m_names->at(lvl);
-		} else {
-			return this->m_names->back();
-		}
+	std::string_view severity_name( const severity_t lvl ) const {
+		return m_definitions[index( lvl )].name;
 	}
 
 	/**
 	 * @return The amount of characters of the longest name of all severity_level
 	 * @note Only important for alignment of severities
 	 */
-	const unsigned int max_name_length() {
-		if ( m_max_name_length == 0 && m_names->size() > 1 ) {
-			for ( size_t i = 0; i < m_names->size()-1; i++ ) { // SKIP last element (SIZE_T)
-				if ( m_names[i].size() > m_max_name_length ) {
-					m_max_name_length = m_names[i].size();
-				}
-			}
-		}
+	unsigned int max_name_length() const {
 		return m_max_name_length;
 	}
+
+	/**
+	 * @return The text that precedes the message of a record with severity lvl, aligned to the longest name (like "   <debug>: ")
+	 * @param lvl A severity_level
+	 * @param colored Wether to enclose it by the color of the severity
+	 */
+	std::string_view prefix( const severity_t lvl, bool colored = false ) const {
+		return colored ? m_colored_prefixes[index( lvl )] : m_prefixes[index( lvl )];
+	}
+};
+
+
+/**
+ * @brief A set of severities with its names and colors defined at compile time. Creating or using it does not allocate.
+ * @note definitions_t: A type with a member static constexpr severity_definition definitions[] that holds
+ * @note a definition for each value of severity_t, including SEVERITY_SIZE
+ */
+template< typename severity_t, typename definitions_t >
+class StaticSeverity
+	:	public AbstractSeverity< severity_t >
+{
+	static constexpr std::size_t size = 1 + (int)severity_t::SEVERITY_SIZE;
+	static_assert( std::size( definitions_t::definitions ) == size, "logcpp: define a severity_definition for each severity, including SEVERITY_SIZE" );
+
+	static constexpr std::size_t max_length = max_severity_name_length( definitions_t::definitions, size );
+	static constexpr std::size_t text_size = severity_prefix_text_size( definitions_t::definitions, size );
+	static constexpr std::array< char, text_size > text = severity_prefix_text< text_size >( definitions_t::definitions, size );
+	static constexpr std::array< std::string_view, size > prefixes = severity_prefix_views< size >( text.data(), definitions_t::definitions, false );
+	static constexpr std::array< std::string_view, size > colored_prefixes = severity_prefix_views< size >( text.data(), definitions_t::definitions, true );
+
+public:
+	/**
+	 * @brief Constructor
+	 */
+	constexpr StaticSeverity()
+		:	AbstractSeverity< severity_t >( definitions_t::definitions, prefixes.data(), colored_prefixes.data(), max_length )
+	{}
+
+	/**
+	 * @return The name for severity_level, evaluated at compile time for constant lvl
+	 * @param lvl A severity_level to get as string
+	 */
+	static constexpr std::string_view name( const severity_t lvl ) {
+		return definitions_t::definitions[static_cast< std::size_t >( lvl ) < size ? static_cast< std::size_t >( lvl ) : size - 1].name;
+	}
+
+	/**
+	 * @brief An instance that loggers can share
+	 */
+	static const StaticSeverity instance;
 };
 
+template< typename severity_t, typename definitions_t >
+const StaticSeverity< severity_t, definitions_t > StaticSeverity< severity_t, definitions_t >::instance;
+
 } // namespace logcpp
 
@@ -62,22 +62,37 @@ enum default_severity_levels {
 };
 
 
+/**
+ * @brief The names and colors of default_severity_levels
+ */
+struct default_severity_definitions {
+	static constexpr severity_definition definitions[] = {
+		{ "off", "" },
+		{ "critical", "\x1b[31m\x1b[1m" },
+		{ "error", "\x1b[31m" },
+		{ "warning", "\x1b[33m" },
+		{ "normal", "" },
+		{ "verbose", "\x1b[36m" },
+		{ "verbose2", "\x1b[34m" },
+		{ "debug", "\x1b[36m\x1b[1m" },
+		{ "debug2", "\x1b[37m\x1b[1m" },
+		{ "SIZE_T", "" }
+	};
+};
+
+
 /**
  * @brief The default severity set that describes the enum default_severity_levels and is used in globallog and severity_logger
+ * @note Loggers share DefaultSeverity::instance, names can be looked up at compile time with DefaultSeverity::name
  */
 class DefaultSeverity
-	:	public AbstractSeverity< default_severity_levels >
+	:	public StaticSeverity< default_severity_levels, default_severity_definitions >
 {
 public:
 	/**
 	 * @brief Constructor
 	 */
-	DefaultSeverity();
-
-	/**
-	 * @brief The names of severity_level as string array
-	 */
-	static std::array < const std::string, 1 + (int)default_severity_levels::SEVERITY_SIZE >* default_severity_names;
+	constexpr DefaultSeverity() {}
 };
 
 } // namespace logcpp
@@ -58,10 +58,18 @@ protected:
 	 * @brief Find out if logging is enabled or not, depending on the current severity values
 	 */
 	bool log_enabled() const {
-		return ( current_severity <= max_severity_lvl && max_severity_lvl != 0 ); // A severity of 0 should default to 'logging off'
+		return will_log( current_severity );
 	}
 
 public:
+	/**
+	 * @brief Find out if records of some severity would be logged with the current maximum severity level
+	 * @param severity The severity to check
+	 */
+	bool will_log( const severity_t severity ) const {
+		return ( severity <= max_severity_lvl && max_severity_lvl != 0 ); // A severity of 0 should default to 'logging off'
+	}
+
 	/**
 	 * @brief Specify, how much output the Logger will produce
 	 * @param severity The maximum severity level that shall be logged
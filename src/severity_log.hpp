@@ -29,6 +29,7 @@
 #pragma once
 
 #include "basic_log.hpp"
+#include "format.hpp"
 #include "severity.hpp"
 #include "severity_feature.hpp"
 #include "logmanip.hpp"
@@ -39,8 +40,7 @@ namespace logcpp {
 /**
  * @brief Abstract description of a severity logger
  * @note severity_t: The type of severity that is to be used
- * @note severity_name: A function taking a severity_t and returning its name
- * @note max_name_length: A function returning the amount of characters of the longest severity name (used for alignment)
+ * @note The names of the severities are inserted as the prefixes rendered by AbstractSeverity< severity_t >
  */
 template< typename severity_t >
 class severity_log
@@ -49,24 +49,53 @@ class severity_log
 {
 protected:
 	/**
-	 * @brief Function that sets the severity
+	 * @brief Function that sets the severity and inserts its prefix
 	 * @param severity Severity level severity level to log
+	 * @note Override it to insert something with each severity. Colors and names are customized through the AbstractSeverity tables.
+	 * @note severity_logger and globallog are final, so the compiler can devirtualize and inline this in them
 	 */
 	virtual void log_severity( const severity_t severity ) {
 		this->current_severity = severity;
-		if( enable_print_severity_ ) {
-			stream << std::setw(m_severity->max_name_length() - m_severity->severity_name( this->current_severity ).length() ) << std::setfill(' ') << "<" << m_severity->severity_name( this->current_severity ) << ">: ";
+		if( enable_print_severity_ && m_binary ) {
+			m_binary->set_flag( stream, binary_flag_severity );	// The decoder prints the name
+		} else if( enable_print_severity_ ) {
+#ifdef LOGCPP_ENABLE_COLOR_SUPPORT
+			const std::string_view prefix = m_severity->prefix( severity, m_color_ok );
+#else
+			const std::string_view prefix = m_severity->prefix( severity );
+#endif
+			stream.insert( prefix.data(), prefix.size() );
 		}
+		stream.end_prefix();
 		this->new_record = false;
 	}
 
 	bool enable_print_severity_;
-	AbstractSeverity< severity_t >* m_severity;
+	/**
+	 * @brief Wether the current record passes the severity filter. Decided when the record begins or its severity is inserted.
+	 */
+	bool record_enabled_;
+	const AbstractSeverity< severity_t >* m_severity;
 
 	/**
 	 * @brief Optional function to be called on critical severity
 	 */
 	void(*abort_f)(void);
+
+	/**
+	 * @brief Append the segments of a format string and its arguments as binary record arguments
+	 */
+	template< typename format_t, std::size_t... index, typename... Args >
+	void log_binary_format( std::index_sequence< index... >, const Args&... args ) {
+		typedef compiled_format< format_t > format;
+		( ( log_binary_segment( format::template segment< index >() ), m_binary->argument( stream, args ) ), ... );
+		log_binary_segment( format::template segment< sizeof...( index ) >() );
+	}
+	void log_binary_segment( std::string_view segment ) {
+		if( !segment.empty() ) {
+			m_binary->argument( stream, segment );
+		}
+	}
     
 public:
 	/**
@@ -87,18 +116,46 @@ public:
 		return *this;
 	}
 
+	/**
+	 * @brief Insert a severity stripped at compile time. Ends the current record and discards everything up to the next endrec.
+	 */
+	null_record operator<<(const stripped_severity&) {
+		if( !new_record && ( !record_enabled_ || stream.has_buffered_content() ) ) {
+			this->end_record();
+		}
+		return null_record();
+	}
+
 	/**
 	 * @brief Constructor
 	 * @param max_severity The maximum severity level for this logger
 	 * @param outbuf A pointer to some std::streambuf where all content is logged to. Defaults to std::cout.rdbuf()
 	 */
-	explicit severity_log( AbstractSeverity< severity_t >* severity
+	explicit severity_log( const AbstractSeverity< severity_t >* severity
 	                     , severity_t max_severity
 	                     , std::streambuf* outbuf = std::cout.rdbuf()
 	)
 	    :	basic_log(outbuf)
 	    ,	severity_feature< severity_t >(max_severity)
 	    ,	enable_print_severity_(true)
+	    ,	record_enabled_(true)
+	    ,	m_severity( severity )
+	    ,	abort_f(nullptr)
+	{}
+
+	/**
+	 * @brief Constructor
+	 * @param max_severity The maximum severity level for this logger
+	 * @param out A pointer to some sink where all records are written to (like a fd_sink)
+	 */
+	explicit severity_log( const AbstractSeverity< severity_t >* severity
+	                     , severity_t max_severity
+	                     , sink* out
+	)
+	    :	basic_log(out)
+	    ,	severity_feature< severity_t >(max_severity)
+	    ,	enable_print_severity_(true)
+	    ,	record_enabled_(true)
 	    ,	m_severity( severity )
 	    ,	abort_f(nullptr)
 	{}
@@ -110,9 +167,11 @@ public:
 	 * @brief Override of basic_log::end_record that only logs when it is enabled by severity
 	 */
 	void end_record() {
-		if( this->log_enabled() ) {
+		if( new_record ? this->log_enabled() : record_enabled_ ) {
+			stream.set_severity( static_cast< int >( this->current_severity ) );
 			basic_log::end_record();
 			if( this->current_severity == 1 && abort_f != nullptr ) {
+				stream.drain();
 				abort_f();
 			}
 		} else {
@@ -136,13 +195,50 @@ public:
 	template< typename T >
 	void log( const T& t) {
 		if( new_record ) {
+			record_enabled_ = this->log_enabled();
+			new_record = false;
+			if( !record_enabled_ ) {
+				return;
+			}
 			insert_time_or_not();
 			if( enable_print_severity_ ) {
-				stream << std::setw(m_severity->max_name_length() - m_severity->severity_name( this->current_severity ).length() ) << std::setfill(' ') << "<" << m_severity->severity_name( this->current_severity ) << ">: " << std::setfill(' ');
+				this->log_severity( this->current_severity );
+			} else {
+				stream.end_prefix();
 			}
+		}
+		if( record_enabled_ ) {	// A filtered record is not formatted at all
+			basic_log::log<T>(t);
+		}
+	}
+
+	/**
+	 * @brief Override of basic_log::log for call sites that drops the record, if the site is switched off (see site_registry)
+	 * @param site The call_site to log
+	 */
+	template< typename T >
+	void log( const call_site& site ) {
+		if( !site.is_enabled() ) {
+			record_enabled_ = false;	// Discarded like a filtered record by end_record
 			new_record = false;
+			return;
+		}
+		if( new_record ) {
+			record_enabled_ = this->log_enabled();
+			new_record = false;
+			if( !record_enabled_ ) {
+				return;
+			}
+			insert_time_or_not();
+			if( enable_print_severity_ ) {
+				this->log_severity( this->current_severity );
+			} else {
+				stream.end_prefix();
+			}
+		}
+		if( record_enabled_ ) {
+			basic_log::log< call_site >( site );
 		}
-		basic_log::log<T>(t);
 	}
 
 	/**
@@ -151,14 +247,44 @@ public:
 	 */
 	template< typename T >
 	void log( const severity_t& severity) {
-		if( !new_record && stream.has_buffered_content() ) {
+		if( !new_record && ( !record_enabled_ || stream.has_buffered_content() ) ) {
 			this->end_record();	// Flush buffer with previous severity before changing the current
-		} else if( new_record ) {
+		}
+		this->current_severity = severity;
+		record_enabled_ = this->log_enabled();
+		if( !record_enabled_ ) {
+			new_record = false;
+			return;
+		}
+		if( new_record ) {
 			insert_time_or_not();
 		}
 		this->log_severity( severity );
 	}
 
+	/**
+	 * @brief Write a complete record from a format string, like lg.log( logcpp::warning, LOGCPP_FORMAT("user {} took {} ms"), id, ms )
+	 * @param severity The severity of the record
+	 * @param format A format string created with LOGCPP_FORMAT. The amount of placeholders is checked against args at compile time.
+	 * @param args The arguments that replace the placeholders {} in order
+	 * @note Ends a record in progress first. Nothing is formatted, if the severity is filtered.
+	 */
+	template< typename format_t, typename... Args >
+	void log( const severity_t severity, format_t format, const Args&... args ) {
+		static_assert( compiled_format< format_t >::arguments == sizeof...( Args ), "logcpp: the amount of arguments does not match the placeholders {} of the format string" );
+		(void)format;
+		this->log< severity_t >( severity );
+		if( record_enabled_ ) {
+			if( m_binary ) {
+				log_binary_format< format_t >( std::index_sequence_for< Args... >(), args... );
+			} else {
+				format_record< format_t >( stream, std::index_sequence_for< Args... >(), args... );
+			}
+			new_record = false;
+		}
+		this->end_record();
+	}
+
 	/**
 	 * @brief A tuple containing a severity and a scope_t
 	 */
@@ -179,6 +305,35 @@ public:
 		this->log< scope_t >(sev_scope.second);
 	}
 
+	/**
+	 * @brief A tuple containing a severity and the call_site of a statement
+	 */
+	typedef std::pair< severity_t, const call_site* > severity_site_t;
+	/**
+	 * @brief Free function that generates a severity_site_t from its parameters
+	 */
+	static severity_site_t severity_site( severity_t severity, const call_site& site ) {
+		return severity_site_t( severity, &site );
+	}
+	/**
+	 * @brief Log a severity_site_t to this log stream (see SCOPE_SEVERITY)
+	 * @param sev_site The severity_site_t to log
+	 */
+	template< typename T >
+	void log( const severity_site_t& sev_site ) {
+		if( !sev_site.second->is_enabled() ) {	// Decided before anything of the record is formatted
+			if( !new_record && ( !record_enabled_ || stream.has_buffered_content() ) ) {
+				this->end_record();
+			}
+			this->current_severity = sev_site.first;
+			record_enabled_ = false;
+			new_record = false;
+			return;
+		}
+		this->log< severity_t >(sev_site.first);
+		this->log< call_site >(*sev_site.second);
+	}
+
 #ifdef LOGCPP_ENABLE_COLOR_SUPPORT
 	/**
 	 * @brief Member function that can send colors before start of
@@ -186,7 +341,7 @@ public:
 	 */
 	template< typename T >
 	void log( const termmode& mode ) {
-		if ( m_color_ok ) {
+		if ( m_color_ok && ( new_record || record_enabled_ ) ) {
 			basic_log::log< termmode >( mode );
 		}
 	}
@@ -197,6 +352,11 @@ public:
 	 * @param enable Enable or disable the loggin of severity names
 	 */
 	void enable_print_severity( bool enable = true ) { enable_print_severity_ = enable; }
+
+	/**
+	 * @returns Wether severity names are logged into the log stream
+	 */
+	bool print_severity_enabled() const { return enable_print_severity_; }
 };
 
 
@@ -35,7 +35,7 @@ namespace logcpp {
  * @param max_severity The maximum severity level for this logger
  */
 severity_logger::severity_logger( default_severity_levels max_severity )
-    :	severity_log< default_severity_levels >( new DefaultSeverity(), max_severity )
+    :	severity_log< default_severity_levels >( &DefaultSeverity::instance, max_severity )
 {
     this->current_severity = normal;
 }
@@ -46,50 +46,25 @@ severity_logger::severity_logger( default_severity_levels max_severity )
  * @param max_severity The maximum severity level for this logger
  */
 severity_logger::severity_logger( std::streambuf* stream, default_severity_levels max_severity )
-    :	severity_log< default_severity_levels >( new DefaultSeverity(), max_severity, stream)
+    :	severity_log< default_severity_levels >( &DefaultSeverity::instance, max_severity, stream)
 {
     this->current_severity = normal;
 }
 
 
-severity_logger::~severity_logger() {}
-
-
 /**
- * @brief Function that optionally inserts colors for severities
- * @param severity Severity level severity level to log
+ * @brief Creates severity_logger logging to a sink
+ * @param out A pointer to some sink where all records are written to (like a fd_sink)
+ * @param max_severity The maximum severity level for this logger
  */
-void severity_logger::log_severity( const default_severity_levels severity ) {
-    this->current_severity = severity;
-#ifdef LOGCPP_AUTOCOLOR
-    if ( severity != off && severity != SEVERITY_SIZE && severity != normal ) {
-        if ( severity == critical ) {
-            severity_log::log<termmode>(col_red);
-            severity_log::log<termmode>(sty_bold);
-        } else if ( severity == error ) {
-            severity_log::log<termmode>(col_red);
-        } else if ( severity == warning ) {
-            severity_log::log<termmode>(col_yellow);
-        } else if ( severity == verbose ) {
-            severity_log::log<termmode>(col_cyan);
-        } else if ( severity == verbose2 ) {
-            severity_log::log<termmode>(col_blue);
-        } else if ( severity == debug ) {
-            severity_log::log<termmode>(col_cyan);
-            severity_log::log<termmode>(sty_bold);
-        } else if ( severity == debug2 ) {
-            severity_log::log<termmode>(col_white);
-            severity_log::log<termmode>(sty_bold);
-        }
-    }
-#endif
-    severity_log::log_severity( severity );
-#ifdef LOGCPP_AUTOCOLOR
-    if ( severity != off && severity != SEVERITY_SIZE && severity != normal ) {
-        severity_log::log<termmode>(ctl_reset_all);
-    }
-#endif
+severity_logger::severity_logger( sink* out, default_severity_levels max_severity )
+    :	severity_log< default_severity_levels >( &DefaultSeverity::instance, max_severity, out )
+{
+    this->current_severity = normal;
 }
 
 
+severity_logger::~severity_logger() {}
+
+
 } // namespace logcpp
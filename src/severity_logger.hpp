@@ -27,8 +27,6 @@
 
 #pragma once
 
-#include <typeinfo>
-
 #include "config.hpp"
 
 #include "severity_log.hpp"
@@ -39,17 +37,11 @@ namespace logcpp {
 
 /**
  * @brief A severity logger that can be used instantly
+ * @note Final, so the compiler can devirtualize severity_log::log_severity on the logging path
  */
-class severity_logger
+class severity_logger final
     :	public severity_log< default_severity_levels >
 {
-protected:
-    /**
-     * @brief Function that optionally inserts colors for severities
-     * @param severity Severity level severity level to log
-     */
-    virtual void log_severity( const default_severity_levels severity );
-
 public:
     /**
      * @brief Override for severity_log::operator<<
@@ -65,26 +57,15 @@ public:
      */
     template< typename T >
     severity_logger& operator<<(const T& t) {
-        if ( new_record && enable_print_severity_
-          && typeid(T) != typeid(default_severity_levels)
-          && typeid(T) != typeid(severity_scope_t)
-        ) {
-            this->log_severity( this->severity() );
-        }
-
         severity_log::log<T>(t);
-
         return *this;
     }
 
     /**
-     * @brief Override for severity_log::operator<<
-     * @param t Some object of type T that can be inserted into a std::ostream
+     * @brief Override for severity_log::operator<< for severities stripped at compile time
      */
-    template< typename T >
-    severity_log& operator<<(const default_severity_levels severity) {
-        this->log_severity( severity );
-        return *this;
+    null_record operator<<(const stripped_severity& stripped) {
+        return severity_log::operator<<( stripped );
     }
 
     /**
@@ -102,6 +83,13 @@ public:
      */
     explicit severity_logger( std::streambuf* stream, default_severity_levels max_severity = normal );
 
+    /**
+     * @brief Creates severity_logger logging to a sink
+     * @param out A pointer to some sink where all records are written to (like a fd_sink)
+     * @param max_severity The maximum severity level for this logger
+     */
+    explicit severity_logger( sink* out, default_severity_levels max_severity = normal );
+
     severity_logger( const severity_logger& ) = delete;
 };
 
@@ -121,52 +109,161 @@ template severity_logger& endrec(severity_logger&);
 } // namespace logcpp
 
 
+/**
+ * @def LOGCPP_MIN_SEVERITY
+ * @brief The least critical severity compiled into the program (like logcpp::normal). Defaults to logcpp::debug2, which keeps all.
+ * @note The severity macros below insert a stripped_severity for less critical severities and the statement macros compile to nothing.
+ * @note A stripped macro is no severity value anymore, so 'set_max_severity_level( DEBUG )' stops compiling. Use logcpp::debug there.
+ */
+#ifndef LOGCPP_MIN_SEVERITY
+#define LOGCPP_MIN_SEVERITY logcpp::debug2
+#endif
+
+
+/**
+ * @def LOGCPP_SEVERITY_COMPILED(lvl_)
+ * @brief Wether records with the severity lvl_ are compiled into the program
+ */
+#define LOGCPP_SEVERITY_COMPILED(lvl_) ( static_cast< int >( lvl_ ) <= static_cast< int >( LOGCPP_MIN_SEVERITY ) )
+
+
+/**
+ * @def LOGCPP_STRIPPABLE(lvl_, severity_)
+ * @brief Expands to severity_, if lvl_ is compiled into the program. Otherwise to a stripped_severity without evaluating severity_.
+ * @note A kept severity is a constant expression, so WARNING and the like work as case labels and at namespace scope
+ */
+#define LOGCPP_STRIPPABLE(lvl_, severity_) logcpp::severity_strip< LOGCPP_SEVERITY_COMPILED(lvl_) >::select( []() constexpr { return severity_; } )
+
+/**
+ * @def LOGCPP_STRIPPABLE_SITE(lvl_, severity_)
+ * @brief Like LOGCPP_STRIPPABLE for a severity_ with a call site. Only usable in functions.
+ * @note severity_ is evaluated in a lambda, where the name of the enclosing function is logcpp_function_ (__func__ is "operator()" there)
+ */
+#define LOGCPP_STRIPPABLE_SITE(lvl_, severity_) logcpp::severity_strip< LOGCPP_SEVERITY_COMPILED(lvl_) >::select( __func__, []( const char* logcpp_function_ ) { return severity_; } )
+
+
 /**
  * @def SCOPE_SEVERITY(lvl_)
  * @brief Insert a severity with the current scope into the severity_logger
  * @param lvl_ The severity level to be inserted into the severity_logger
  */
-#define SCOPE_SEVERITY(lvl_) logcpp::severity_log< logcpp::default_severity_levels >::severity_scope(lvl_, SCOPE)
+#define SCOPE_SEVERITY(lvl_) LOGCPP_SCOPE_SEVERITY_IN(lvl_, __func__)
+
+/**
+ * @def LOGCPP_SCOPE_SEVERITY_IN(lvl_, function_)
+ * @brief Like SCOPE_SEVERITY with the name of the function given (see LOGCPP_CALL_SITE_SEVERITY_IN)
+ */
+#define LOGCPP_SCOPE_SEVERITY_IN(lvl_, function_) logcpp::severity_log< logcpp::default_severity_levels >::severity_site(lvl_, LOGCPP_CALL_SITE_SEVERITY_IN(lvl_, function_))
 
 
 /**
  * @def CRITICAL
  * @brief Insert a critical scope into the log stream that may call the critical function of severity_log
  */
-#define CRITICAL SCOPE_SEVERITY(logcpp::critical)
+#define CRITICAL LOGCPP_STRIPPABLE_SITE(logcpp::critical, LOGCPP_SCOPE_SEVERITY_IN(logcpp::critical, logcpp_function_))
 
 /**
  * @def ERROR
  * @brief Insert a error into the log stream
  */
-#define ERROR SCOPE_SEVERITY(logcpp::error)
+#define ERROR LOGCPP_STRIPPABLE_SITE(logcpp::error, LOGCPP_SCOPE_SEVERITY_IN(logcpp::error, logcpp_function_))
 
 /**
  * @def WARNING
  * @brief Insert a warning into the log stream
  */
-#define WARNING logcpp::warning
+#define WARNING LOGCPP_STRIPPABLE(logcpp::warning, logcpp::warning)
 
 /**
  * @def VERBOSE
  * @brief Insert a verbose into the log stream
  */
-#define VERBOSE logcpp::verbose
+#define VERBOSE LOGCPP_STRIPPABLE(logcpp::verbose, logcpp::verbose)
 
 /**
  * @def VERBOSE2
  * @brief Insert a verbose2 into the log stream
  */
-#define VERBOSE2 logcpp::verbose2
+#define VERBOSE2 LOGCPP_STRIPPABLE(logcpp::verbose2, logcpp::verbose2)
 
 /**
  * @def DEBUG
  * @brief Insert a debug severity into the log stream
  */
-#define DEBUG logcpp::debug
+#define DEBUG LOGCPP_STRIPPABLE(logcpp::debug, logcpp::debug)
 
 /**
  * @def DEBUG2
  * @brief Insert a debug2 scope into the log stream
  */
-#define DEBUG2 SCOPE_SEVERITY(logcpp::debug2)
+#define DEBUG2 LOGCPP_STRIPPABLE_SITE(logcpp::debug2, LOGCPP_SCOPE_SEVERITY_IN(logcpp::debug2, logcpp_function_))
+
+
+/**
+ * @def LOGCPP_IF_COMPILED(lvl_)
+ * @brief Begins a statement that is only compiled into the program, if lvl_ is at least as critical as LOGCPP_MIN_SEVERITY
+ */
+#define LOGCPP_IF_COMPILED(lvl_) if( !logcpp::severity_strip< LOGCPP_SEVERITY_COMPILED(lvl_) >::enabled ) {} else
+
+/**
+ * @def LOGCPP_IF_ENABLED(lg_, lvl_)
+ * @brief Begins a statement that is only executed, if lvl_ is compiled into the program and the logger lg_ would log it
+ * @note lg_ is evaluated twice
+ */
+#define LOGCPP_IF_ENABLED(lg_, lvl_) LOGCPP_IF_COMPILED(lvl_) if( !(lg_).will_log( lvl_ ) ) {} else
+
+/**
+ * @def LOGCPP_LOG(lg_, lvl_)
+ * @brief Begin a record with a severity like 'LOGCPP_LOG(stdlog, logcpp::debug) << x << logcpp::endrec'
+ * @note If the logger filters the severity, x is not evaluated. If the severity is stripped, the whole statement compiles to nothing.
+ */
+#define LOGCPP_LOG(lg_, lvl_) LOGCPP_IF_ENABLED(lg_, lvl_) (lg_) << lvl_
+
+/**
+ * @def LOGCPP_LOGF(lg_, lvl_, format_, ...)
+ * @brief Write a record from a format string like 'LOGCPP_LOGF(stdlog, logcpp::debug, "user {} took {} ms", id, ms)'
+ * @note Uses lg_.log( lvl_, LOGCPP_FORMAT(format_), ... ). The arguments are not evaluated, if the logger filters the severity.
+ */
+#define LOGCPP_LOGF(lg_, lvl_, format_, ...) LOGCPP_IF_ENABLED(lg_, lvl_) (lg_).log( lvl_, LOGCPP_FORMAT(format_), ##__VA_ARGS__ )
+
+/**
+ * @def LOGCPP_CRITICAL(lg_)
+ * @brief Begin a record like 'lg_ << CRITICAL' that is skipped, if lg_ filters critical, and compiles to nothing, if critical is stripped
+ */
+#define LOGCPP_CRITICAL(lg_) LOGCPP_IF_ENABLED(lg_, logcpp::critical) (lg_) << CRITICAL
+
+/**
+ * @def LOGCPP_ERROR(lg_)
+ * @brief Begin a record like 'lg_ << ERROR' that is skipped, if lg_ filters error, and compiles to nothing, if error is stripped
+ */
+#define LOGCPP_ERROR(lg_) LOGCPP_IF_ENABLED(lg_, logcpp::error) (lg_) << ERROR
+
+/**
+ * @def LOGCPP_WARNING(lg_)
+ * @brief Begin a record like 'lg_ << WARNING' that is skipped, if lg_ filters warning, and compiles to nothing, if warning is stripped
+ */
+#define LOGCPP_WARNING(lg_) LOGCPP_IF_ENABLED(lg_, logcpp::warning) (lg_) << WARNING
+
+/**
+ * @def LOGCPP_VERBOSE(lg_)
+ * @brief Begin a record like 'lg_ << VERBOSE' that is skipped, if lg_ filters verbose, and compiles to nothing, if verbose is stripped
+ */
+#define LOGCPP_VERBOSE(lg_) LOGCPP_IF_ENABLED(lg_, logcpp::verbose) (lg_) << VERBOSE
+
+/**
+ * @def LOGCPP_VERBOSE2(lg_)
+ * @brief Begin a record like 'lg_ << VERBOSE2' that is skipped, if lg_ filters verbose2, and compiles to nothing, if verbose2 is stripped
+ */
+#define LOGCPP_VERBOSE2(lg_) LOGCPP_IF_ENABLED(lg_, logcpp::verbose2) (lg_) << VERBOSE2
+
+/**
+ * @def LOGCPP_DEBUG(lg_)
+ * @brief Begin a record like 'lg_ << DEBUG' that is skipped, if lg_ filters debug, and compiles to nothing, if debug is stripped
+ */
+#define LOGCPP_DEBUG(lg_) LOGCPP_IF_ENABLED(lg_, logcpp::debug) (lg_) << DEBUG
+
+/**
+ * @def LOGCPP_DEBUG2(lg_)
+ * @brief Begin a record like 'lg_ << DEBUG2' that is skipped, if lg_ filters debug2, and compiles to nothing, if debug2 is stripped
+ */
+#define LOGCPP_DEBUG2(lg_) LOGCPP_IF_ENABLED(lg_, logcpp::debug2) (lg_) << DEBUG2
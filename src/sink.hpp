@@ -0,0 +1,159 @@
+/**
+ * @file sink.hpp
+ * @brief The interface of targets that finished log records are written to
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+	LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+	Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+	Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+	USA
+*/
+
+
+#pragma once
+
+#include "config.hpp"
+
+#include <cstddef>
+#include <ios>
+#include <streambuf>
+
+
+namespace logcpp {
+
+/**
+ * @brief A view on a finished record that is handed to a sink
+ * @note The prefix holds what a logger inserts in front of the content (like the timestamp and the severity)
+ */
+struct record_view {
+	/**
+	 * @brief The first byte of the prefix
+	 */
+	const char* prefix;
+	/**
+	 * @brief The amount of bytes in the prefix
+	 */
+	std::size_t prefix_size;
+	/**
+	 * @brief The first byte of the content
+	 */
+	const char* body;
+	/**
+	 * @brief The amount of bytes in the content
+	 */
+	std::size_t body_size;
+	/**
+	 * @brief Wether the record ends with a newline that is not part of body
+	 */
+	bool terminated;
+	/**
+	 * @brief The severity of the record as integer or no_severity, if the logger has no severities
+	 */
+	int severity;
+
+	/**
+	 * @brief Value of severity for records without a severity
+	 */
+	static const int no_severity = -1;
+};
+
+
+/**
+ * @brief The abstract target of a logger
+ */
+class sink {
+public:
+	virtual ~sink() {}
+
+	/**
+	 * @brief Write a record to this sink
+	 * @param record The record to write. Its memory is only valid during this call.
+	 */
+	virtual void write( const record_view& record ) = 0;
+
+	/**
+	 * @brief Push all content buffered by this sink to its target
+	 */
+	virtual void flush() = 0;
+
+	/**
+	 * @brief Block until all records written to this sink reached their target
+	 * @note Defaults to flush for sinks that write synchronously
+	 */
+	virtual void drain() { flush(); }
+
+	/**
+	 * @brief Flush and wait until everything written so far is stored durably (like with fdatasync)
+	 * @note Defaults to flush for sinks that cannot make their target durable
+	 */
+	virtual void sync() { flush(); }
+
+	/**
+	 * @brief Determines, if the sink is a terminal
+	 */
+	virtual bool is_terminal() const { return false; }
+};
+
+
+/**
+ * @brief A sink writing to a std::streambuf (like std::cout.rdbuf() or the rdbuf() of a std::ofstream)
+ */
+class streambuf_sink
+	:	public sink
+{
+protected:
+	std::streambuf* m_out;
+
+public:
+	/**
+	 * @brief Constructor
+	 * @param outbuf A pointer to some streambuf where all records are written to
+	 */
+	explicit streambuf_sink( std::streambuf* outbuf )
+		:	m_out( outbuf )
+	{}
+
+	virtual void write( const record_view& record ) {
+		if ( m_out == nullptr ) {
+			return;
+		}
+		m_out->sputn( record.prefix, static_cast< std::streamsize >( record.prefix_size ) );
+		m_out->sputn( record.body, static_cast< std::streamsize >( record.body_size ) );
+		if ( record.terminated ) {
+			m_out->sputc( '\n' );
+		}
+	}
+
+	virtual void flush() {
+		if ( m_out != nullptr ) {
+			m_out->pubsync();
+		}
+	}
+
+	/**
+	 * @brief Determines, if the underlying streambuf is a terminal
+	 * @note Will fail in some cases where a terminal supports positioning
+	 */
+	virtual bool is_terminal() const {
+		return ( m_out != nullptr
+		      && m_out->pubseekoff( 0, std::ios_base::cur, std::ios_base::out ) == std::streampos( -1 ) );
+	}
+};
+
+
+} // namespace logcpp
@@ -0,0 +1,148 @@
+/**
+ * @file timestamp.cpp
+ * @brief Cached formatting of timestamps into record buffers
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+    LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+    Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+    Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 3 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+    USA
+*/
+
+
+#include "timestamp.hpp"
+
+#include <climits>
+#include <cstring>
+#include <ctime>
+
+
+namespace logcpp {
+
+namespace {
+
+/**
+ * @brief The calendar fields of one minute in local time, formatted once per thread
+ */
+struct minute_cache {
+    long long minute;   // Minutes since the epoch, LLONG_MIN if empty
+    char prefix[18];    // Like 2021-03-04_13:37:
+    char offset[7];     // Like +01:00
+};
+
+thread_local minute_cache cache = { LLONG_MIN, { 0 }, { 0 } };
+
+
+inline void write_digits( char* out, unsigned long long value, std::size_t digits ) {
+    for ( std::size_t i = digits; i > 0; i-- ) {
+        out[i - 1] = static_cast< char >( '0' + value % 10 );
+        value /= 10;
+    }
+}
+
+
+void refresh( minute_cache& c, long long minute ) {
+    std::time_t rawtime = static_cast< std::time_t >( minute * 60 );
+    struct std::tm local;
+    struct std::tm utc;
+#ifdef _WIN32
+    localtime_s( &local, &rawtime );
+    gmtime_s( &utc, &rawtime );
+#else
+    localtime_r( &rawtime, &local );
+    gmtime_r( &rawtime, &utc );
+#endif
+    std::strftime( c.prefix, sizeof( c.prefix ), "%Y-%m-%d_%H:%M:", &local );
+
+    int day = 0;
+    if ( local.tm_year != utc.tm_year ) {
+        day = ( local.tm_year > utc.tm_year ? 1 : -1 );
+    } else if ( local.tm_yday != utc.tm_yday ) {
+        day = ( local.tm_yday > utc.tm_yday ? 1 : -1 );
+    }
+    int offset = day * 24 * 60 + ( local.tm_hour - utc.tm_hour ) * 60 + ( local.tm_min - utc.tm_min );
+    c.offset[0] = ( offset < 0 ? '-' : '+' );
+    if ( offset < 0 ) {
+        offset = -offset;
+    }
+    write_digits( c.offset + 1, static_cast< unsigned long long >( offset / 60 ), 2 );
+    c.offset[3] = ':';
+    write_digits( c.offset + 4, static_cast< unsigned long long >( offset % 60 ), 2 );
+    c.offset[6] = 0;
+
+    c.minute = minute;
+}
+
+} // namespace
+
+
+std::size_t format_timestamp( char* out, std::chrono::system_clock::time_point time, timestamp_format format, timestamp_precision precision ) {
+    long long nanos = std::chrono::duration_cast< std::chrono::nanoseconds >( time.time_since_epoch() ).count();
+
+    if ( format == time_epoch_nanos ) {
+        unsigned long long value = static_cast< unsigned long long >( nanos < 0 ? 0 : nanos );
+        std::size_t digits = 1;
+        for ( unsigned long long rest = value / 10; rest > 0; rest /= 10 ) {
+            digits++;
+        }
+        write_digits( out, value, digits );
+        return digits;
+    }
+
+    long long seconds = nanos / 1000000000;
+    long long fraction = nanos % 1000000000;
+    if ( fraction < 0 ) {
+        fraction += 1000000000;
+        seconds--;
+    }
+    long long minute = seconds / 60;
+    if ( seconds % 60 < 0 ) {
+        minute--;
+    }
+
+    if ( cache.minute != minute ) {
+        refresh( cache, minute );
+    }
+
+    std::memcpy( out, cache.prefix, 17 );
+    if ( format == time_iso8601 ) {
+        out[10] = 'T';
+    }
+    write_digits( out + 17, static_cast< unsigned long long >( seconds - minute * 60 ), 2 );
+    std::size_t size = 19;
+
+    if ( precision != time_seconds ) {
+        std::size_t digits = ( precision == time_millis ? 3 : precision == time_micros ? 6 : 9 );
+        unsigned long long value = static_cast< unsigned long long >( fraction );
+        for ( std::size_t i = digits; i < 9; i++ ) {
+            value /= 10;
+        }
+        out[size++] = '.';
+        write_digits( out + size, value, digits );
+        size += digits;
+    }
+
+    if ( format == time_iso8601 ) {
+        std::memcpy( out + size, cache.offset, 6 );
+        size += 6;
+    }
+    return size;
+}
+
+
+} // namespace logcpp
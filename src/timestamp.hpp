@@ -0,0 +1,101 @@
+/**
+ * @file timestamp.hpp
+ * @brief Cached formatting of timestamps into record buffers
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+	LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+	Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+	Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+	USA
+*/
+
+
+
+#pragma once
+
+#include "config.hpp"
+
+#include <chrono>
+#include <cstddef>
+
+
+namespace logcpp {
+
+/**
+ * @brief The layouts timestamps can be written in
+ */
+enum timestamp_format {
+	/**
+	 * @brief Local time like %F_%T (2021-03-04_13:37:42)
+	 */
+	time_default,
+	/**
+	 * @brief Local time as ISO-8601 with UTC offset (2021-03-04T13:37:42+01:00)
+	 */
+	time_iso8601,
+	/**
+	 * @brief Nanoseconds since the epoch (1614861462123456789). Ignores the precision.
+	 */
+	time_epoch_nanos
+};
+
+
+/**
+ * @brief The fraction of a second appended to the seconds of a timestamp
+ */
+enum timestamp_precision {
+	time_seconds,
+	time_millis,
+	time_micros,
+	time_nanos
+};
+
+
+/**
+ * @brief The maximal amount of bytes written by format_timestamp
+ */
+const std::size_t max_timestamp_size = 40;
+
+
+/**
+ * @brief Write a point in time into a buffer
+ * @note Each thread caches the calendar fields of the current minute, so only the seconds and their fraction are formatted for most records.
+ * @param out The buffer to write to. Must hold at least max_timestamp_size bytes.
+ * @param time The point in time to write
+ * @param format The layout of the timestamp
+ * @param precision The fraction of a second to append
+ * @returns The amount of bytes written
+ */
+std::size_t format_timestamp( char* out
+                            , std::chrono::system_clock::time_point time
+                            , timestamp_format format = time_default
+                            , timestamp_precision precision = time_seconds
+);
+
+/**
+ * @brief Write the current time into a buffer
+ * @param out The buffer to write to. Must hold at least max_timestamp_size bytes.
+ * @param format The layout of the timestamp
+ * @param precision The fraction of a second to append
+ * @returns The amount of bytes written
+ */
+inline std::size_t format_timestamp( char* out, timestamp_format format = time_default, timestamp_precision precision = time_seconds ) {
+	return format_timestamp( out, std::chrono::system_clock::now(), format, precision );
+}
+
+} // namespace logcpp
@@ -0,0 +1,242 @@
+/**
+ * @file async_sink_policies.cpp
+ * @brief Test: async_sink delivers in order from several threads and counts what its overflow policies drop
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+    LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+    Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+    Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 3 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+    USA
+*/
+
+
+
+#include "async_sink.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace {
+
+int failures = 0;
+
+void expect( bool condition, const std::string& what ) {
+    if ( !condition ) {
+        std::cerr << "async_sink_policies: " << what << std::endl;
+        failures++;
+    }
+}
+
+/**
+ * @brief A sink collecting the bodies of all records. While it is closed, write waits, which keeps the writer thread and its slot busy.
+ */
+class gated_sink
+    :   public logcpp::sink
+{
+    std::mutex m_lock;
+    std::condition_variable m_changed;
+    bool m_open;
+    bool m_entered;
+
+public:
+    std::vector< std::string > records;
+
+    gated_sink()
+        :   m_open( true )
+        ,   m_entered( false )
+    {}
+
+    virtual void write( const logcpp::record_view& record ) {
+        std::unique_lock< std::mutex > lock( m_lock );
+        m_entered = true;
+        m_changed.notify_all();
+        m_changed.wait( lock, [this]() { return m_open; } );
+        records.emplace_back( record.body, record.body_size );
+    }
+
+    virtual void flush() {}
+
+    void close() {
+        std::lock_guard< std::mutex > guard( m_lock );
+        m_open = false;
+        m_entered = false;
+    }
+
+    void open() {
+        std::lock_guard< std::mutex > guard( m_lock );
+        m_open = true;
+        m_changed.notify_all();
+    }
+
+    /**
+     * @brief Wait until the writer thread is inside write
+     */
+    void wait_entered() {
+        std::unique_lock< std::mutex > lock( m_lock );
+        m_changed.wait( lock, [this]() { return m_entered; } );
+    }
+};
+
+void write( logcpp::async_sink& queue, const std::string& body, int severity ) {
+    logcpp::record_view record = { body.data(), 0, body.data(), body.size(), true, severity };
+    queue.write( record );
+}
+
+/**
+ * @brief Close the gate, queue record 0 and wait until the writer thread is stuck writing it
+ */
+void stall( gated_sink& target, logcpp::async_sink& queue ) {
+    target.close();
+    write( queue, "0", logcpp::normal );
+    target.wait_entered();
+}
+
+/**
+ * @brief Open the gate after a while from another thread, so that a blocked write can continue
+ */
+std::thread open_later( gated_sink& target ) {
+    return std::thread( [&target]() {
+        std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+        target.open();
+    } );
+}
+
+
+void test_block_keeps_order() {
+    const int threads = 4;
+    const int records = 20000;
+    gated_sink target;
+    logcpp::async_sink queue( &target, 8, 4 );
+
+    std::vector< std::thread > producers;
+    for ( int t = 0; t < threads; t++ ) {
+        producers.emplace_back( [&queue, t]() {
+            for ( int i = 0; i < records; i++ ) {
+                write( queue, std::to_string( t ) + " " + std::to_string( i ), logcpp::normal );
+            }
+        } );
+    }
+    for ( std::thread& producer : producers ) {
+        producer.join();
+    }
+    queue.drain();
+
+    expect( target.records.size() == static_cast< std::size_t >( threads * records ), "block: delivered " + std::to_string( target.records.size() ) + " records" );
+    expect( queue.dropped_total() == 0, "block: dropped records" );
+    std::vector< int > next( threads, 0 );
+    for ( const std::string& record : target.records ) {
+        const std::size_t space = record.find( ' ' );
+        const int t = std::stoi( record.substr( 0, space ) );
+        const int i = std::stoi( record.substr( space + 1 ) );
+        if ( i != next[t] ) {
+            expect( false, "block: thread " + std::to_string( t ) + " delivered record " + std::to_string( i ) + " instead of " + std::to_string( next[t] ) );
+            return;
+        }
+        next[t]++;
+    }
+}
+
+
+void test_drop_newest() {
+    gated_sink target;
+    {
+        logcpp::async_sink queue( &target, 4 );
+        queue.set_overflow_policy( logcpp::overflow_drop_newest );
+        queue.set_drop_report_interval( std::chrono::hours( 1 ) );     // Only the summary at destruction
+        stall( target, queue );
+
+        for ( int i = 1; i < 10; i++ ) {
+            write( queue, std::to_string( i ), logcpp::normal );     // 1 to 3 fill the free slots
+        }
+        expect( queue.dropped( logcpp::normal ) == 6, "drop_newest: dropped " + std::to_string( queue.dropped( logcpp::normal ) ) + " instead of 6 records" );
+        expect( queue.dropped_total() == 6, "drop_newest: dropped records of other severities" );
+
+        target.open();
+        queue.drain();
+        const std::vector< std::string > expected = { "0", "1", "2", "3" };
+        expect( target.records == expected, "drop_newest: did not deliver the oldest records" );
+    }
+    expect( target.records.size() == 5 && target.records.back().find( "dropped 6 records" ) != std::string::npos, "drop_newest: no summary of the dropped records" );
+}
+
+
+void test_drop_oldest() {
+    gated_sink target;
+    logcpp::async_sink queue( &target, 4 );
+    queue.set_overflow_policy( logcpp::overflow_drop_oldest );
+    queue.set_drop_report_interval( std::chrono::milliseconds( 0 ) );
+    stall( target, queue );
+
+    for ( int i = 1; i < 4; i++ ) {
+        write( queue, std::to_string( i ), logcpp::normal );
+    }
+    std::thread opener = open_later( target );
+    for ( int i = 4; i < 10; i++ ) {
+        write( queue, std::to_string( i ), logcpp::normal );     // Drops 1 to 3, then waits for record 0
+    }
+    opener.join();
+    queue.drain();
+
+    expect( queue.dropped( logcpp::normal ) >= 3, "drop_oldest: dropped " + std::to_string( queue.dropped( logcpp::normal ) ) + " instead of at least 3 records" );
+    expect( target.records.size() + queue.dropped_total() == 10, "drop_oldest: records were lost without being counted" );
+    expect( !target.records.empty() && target.records.back() == "9", "drop_oldest: the newest record was not delivered" );
+    for ( std::size_t i = 1; i < target.records.size(); i++ ) {
+        expect( std::stoi( target.records[i - 1] ) < std::stoi( target.records[i] ), "drop_oldest: records out of order" );
+    }
+    for ( const std::string& record : target.records ) {
+        expect( record != "1" && record != "2" && record != "3", "drop_oldest: delivered record " + record + ", which should be dropped" );
+    }
+}
+
+
+void test_drop_below_severity() {
+    gated_sink target;
+    logcpp::async_sink queue( &target, 4 );
+    queue.set_overflow_policy( logcpp::overflow_drop_below_severity, logcpp::error );
+    queue.set_drop_report_interval( std::chrono::milliseconds( 0 ) );
+    stall( target, queue );
+
+    for ( int i = 1; i < 9; i++ ) {
+        write( queue, std::to_string( i ), logcpp::debug );     // 1 to 3 fill the free slots
+    }
+    std::thread opener = open_later( target );
+    write( queue, "error", logcpp::error );     // Waits instead of being dropped
+    opener.join();
+    queue.drain();
+
+    expect( queue.dropped( logcpp::debug ) == 5, "drop_below_severity: dropped " + std::to_string( queue.dropped( logcpp::debug ) ) + " instead of 5 debug records" );
+    expect( queue.dropped( logcpp::error ) == 0, "drop_below_severity: dropped an error" );
+    expect( !target.records.empty() && target.records.back() == "error", "drop_below_severity: the error was not delivered" );
+}
+
+} // namespace
+
+
+int main() {
+    test_block_keeps_order();
+    test_drop_newest();
+    test_drop_oldest();
+    test_drop_below_severity();
+    return ( failures == 0 ? 0 : 1 );
+}
@@ -0,0 +1,67 @@
+/**
+ * @file call_site_function.cpp
+ * @brief Test: Call sites of the severity macros know the function they are in
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+    LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+    Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+    Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 3 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+    USA
+*/
+
+
+#include "severity_logger.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+
+namespace {
+
+void handle_request( logcpp::severity_logger& log ) {
+    log << CRITICAL << "critical" << logcpp::endrec;
+    log << ERROR << "error" << logcpp::endrec;
+    log << DEBUG2 << "debug2" << logcpp::endrec;
+    log << SCOPE_SEVERITY( logcpp::warning ) << "warning" << logcpp::endrec;
+    log << logcpp::normal << SCOPE << "normal" << logcpp::endrec;
+}
+
+} // namespace
+
+
+int main() {
+    std::ostringstream out;
+    logcpp::severity_logger log( out.rdbuf(), logcpp::debug2 );
+    handle_request( log );
+
+    int failures = 0;
+    for ( const logcpp::call_site* site : logcpp::site_registry::sites() ) {
+        const char* function = site->function.load();
+        if ( function == nullptr || std::strcmp( function, "handle_request" ) != 0 ) {
+            std::cerr << "call_site_function: site in line " << site->line << " has function " << ( function != nullptr ? function : "(none)" )
+                      << ", expected handle_request" << std::endl;
+            failures++;
+        }
+    }
+    if ( logcpp::site_registry::sites().size() != 5 ) {
+        std::cerr << "call_site_function: " << logcpp::site_registry::sites().size() << " sites registered, expected 5" << std::endl;
+        failures++;
+    }
+    return ( failures == 0 ? 0 : 1 );
+}
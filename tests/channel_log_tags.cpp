@@ -0,0 +1,78 @@
+/**
+ * @file channel_log_tags.cpp
+ * @brief Test: SCOPE and stripped severities reach each channel of a channel_log
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+    LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+    Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+    Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 3 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+    USA
+*/
+
+
+#define LOGCPP_MIN_SEVERITY logcpp::normal	// DEBUG is stripped
+
+#include "channel_log.hpp"
+#include "severity_logger.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+
+namespace {
+
+int failures = 0;
+
+void expect( bool condition, const std::string& channel, const std::string& what ) {
+    if ( !condition ) {
+        std::cerr << "channel_log_tags: channel " << channel << ": " << what << std::endl;
+        failures++;
+    }
+}
+
+} // namespace
+
+
+int main() {
+    std::ostringstream first_out;
+    std::ostringstream second_out;
+    logcpp::severity_logger first( first_out.rdbuf(), logcpp::debug2 );
+    logcpp::severity_logger second( second_out.rdbuf(), logcpp::debug2 );
+
+    logcpp::channel_log< logcpp::severity_logger > channels;
+    channels.add_channel( "first", first );
+    channels.add_channel( "second", second );
+    channels.enable_channel( "first" );
+    channels.enable_channel( "second" );
+
+    channels << logcpp::warning << SCOPE << "with scope" << logcpp::endrec;
+    channels << DEBUG << "stripped" << logcpp::endrec;
+    channels << logcpp::error << "after" << logcpp::endrec;
+
+    const std::string outputs[] = { first_out.str(), second_out.str() };
+    const char* names[] = { "first", "second" };
+    for ( int i = 0; i < 2; i++ ) {
+        const std::string& out = outputs[i];
+        expect( out.find( "<warning>: [ channel_log_tags.cpp:" ) != std::string::npos, names[i], "no SCOPE after the severity prefix in \"" + out + "\"" );
+        expect( out.find( "] : with scope\n" ) != std::string::npos, names[i], "no record with scope in \"" + out + "\"" );
+        expect( out.find( "stripped" ) == std::string::npos, names[i], "the record of a stripped severity was written" );
+        expect( out.find( "<error>: after\n" ) != std::string::npos, names[i], "no record after the stripped one in \"" + out + "\"" );
+    }
+    return ( failures == 0 ? 0 : 1 );
+}
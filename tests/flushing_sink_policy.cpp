@@ -0,0 +1,166 @@
+/**
+ * @file flushing_sink_policy.cpp
+ * @brief Test: flushing_sink flushes its target exactly when a trigger of its flush_policy fires
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+    LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+    Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+    Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 3 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+    USA
+*/
+
+
+
+#include "flushing_sink.hpp"
+#include "severity_logger.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+
+namespace {
+
+int failures = 0;
+
+void expect( bool condition, const std::string& what ) {
+    if ( !condition ) {
+        std::cerr << "flushing_sink_policy: " << what << std::endl;
+        failures++;
+    }
+}
+
+/**
+ * @brief A sink recording the calls it gets as letters: w(rite), f(lush), s(ync) and d(rain)
+ */
+class recording_sink
+    :   public logcpp::sink
+{
+    mutable std::mutex m_lock;
+    std::string m_calls;
+
+    void record( char call ) {
+        std::lock_guard< std::mutex > guard( m_lock );
+        m_calls += call;
+    }
+
+public:
+    virtual void write( const logcpp::record_view& ) { record( 'w' ); }
+    virtual void flush() { record( 'f' ); }
+    virtual void sync() { record( 's' ); }
+    virtual void drain() { record( 'd' ); }
+
+    std::string calls() const {
+        std::lock_guard< std::mutex > guard( m_lock );
+        return m_calls;
+    }
+};
+
+void write( logcpp::sink& out, const std::string& body, int severity = logcpp::normal ) {
+    logcpp::record_view record = { body.data(), 0, body.data(), body.size(), true, severity };
+    out.write( record );
+}
+
+void expect_calls( const recording_sink& target, const std::string& expected, const std::string& what ) {
+    expect( target.calls() == expected, what + ": the target got \"" + target.calls() + "\" instead of \"" + expected + "\"" );
+}
+
+
+void test_records() {
+    recording_sink target;
+    {
+        logcpp::flushing_sink out( &target, logcpp::flush_policy( 3 ) );
+        logcpp::severity_logger lg( &out, logcpp::debug2 );
+        for ( int i = 0; i < 4; i++ ) {
+            lg << logcpp::normal << "record " << i << logcpp::endrec;   // The logger flushes after each record
+        }
+        expect_calls( target, "wwwfw", "records" );
+    }
+    expect_calls( target, "wwwfwf", "records: destructor" );
+}
+
+
+void test_bytes() {
+    recording_sink target;
+    logcpp::flushing_sink out( &target, logcpp::flush_policy( 0, 20 ) );
+    write( out, "eleven byte" );    // 12 bytes with the newline
+    expect_calls( target, "w", "bytes" );
+    write( out, "eleven byte" );
+    write( out, "eleven byte" );
+    expect_calls( target, "wwfw", "bytes" );
+}
+
+
+void test_severity() {
+    recording_sink target;
+    logcpp::flushing_sink out( &target, logcpp::flush_policy( 0, 0, std::chrono::milliseconds( 0 ), logcpp::error ) );
+    write( out, "a warning", logcpp::warning );
+    write( out, "no severity", logcpp::record_view::no_severity );
+    expect_calls( target, "ww", "severity" );
+    write( out, "an error", logcpp::error );
+    write( out, "critical", logcpp::critical );
+    expect_calls( target, "wwwfwf", "severity" );
+}
+
+
+void test_sync() {
+    recording_sink target;
+    logcpp::flushing_sink out( &target, logcpp::flush_policy( 2, 0, std::chrono::milliseconds( 0 ), logcpp::off, true ) );
+    write( out, "first" );
+    write( out, "second" );
+    expect_calls( target, "wws", "sync" );
+    out.flush();
+    write( out, "third" );
+    out.drain();
+    expect_calls( target, "wwswds", "sync: drain" );
+}
+
+
+void test_interval() {
+    recording_sink target;
+    logcpp::flushing_sink out( &target, logcpp::flush_policy( 0, 0, std::chrono::milliseconds( 20 ) ) );
+    write( out, "pending" );
+    for ( int i = 0; i < 200 && target.calls() != "wf"; i++ ) {
+        std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+    }
+    expect_calls( target, "wf", "interval" );
+}
+
+
+void test_drain() {
+    recording_sink target;
+    logcpp::flushing_sink out( &target, logcpp::flush_policy( 0 ) );
+    write( out, "queued" );
+    out.drain();
+    expect_calls( target, "wdf", "drain" );
+}
+
+} // namespace
+
+
+int main() {
+    test_records();
+    test_bytes();
+    test_severity();
+    test_sync();
+    test_interval();
+    test_drain();
+    return ( failures == 0 ? 0 : 1 );
+}
@@ -0,0 +1,105 @@
+/**
+ * @file record_allocations.cpp
+ * @brief Test: A typical severity_logger record does not allocate on the heap
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+    LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+    Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+    Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 3 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+    USA
+*/
+
+
+#include "severity_logger.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+
+namespace {
+
+/**
+ * @brief The amount of heap allocations since the program started
+ */
+std::size_t allocations = 0;
+
+/**
+ * @brief A sink that discards all records
+ */
+class null_sink
+	:	public logcpp::sink
+{
+public:
+	virtual void write( const logcpp::record_view& ) {}
+	virtual void flush() {}
+};
+
+} // namespace
+
+
+void* operator new( std::size_t size ) {
+    allocations++;
+    void* memory = std::malloc( size > 0 ? size : 1 );
+    if ( memory == nullptr ) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new[]( std::size_t size ) {
+    return operator new( size );
+}
+
+void operator delete( void* memory ) noexcept {
+    std::free( memory );
+}
+
+void operator delete[]( void* memory ) noexcept {
+    std::free( memory );
+}
+
+void operator delete( void* memory, std::size_t ) noexcept {
+    std::free( memory );
+}
+
+void operator delete[]( void* memory, std::size_t ) noexcept {
+    std::free( memory );
+}
+
+
+int main() {
+    null_sink out;
+    logcpp::severity_logger log( &out, logcpp::debug );
+    log.enable_timestamp();
+    const std::string name( "worker" );   // Short enough for the small string buffer
+
+    const std::size_t before = allocations;
+    for ( int i = 0; i < 1000; i++ ) {
+        log << logcpp::warning << "request " << i << " of " << name << " took " << 0.25 * i << " ms" << logcpp::endrec;
+        log << logcpp::debug << "retries: " << 3u << ", ok: " << true << logcpp::endrec;
+    }
+    const std::size_t count = allocations - before;
+
+    if ( count != 0 ) {
+        std::cerr << "record_allocations: " << count << " heap allocations for 2000 records, expected none" << std::endl;
+        return 1;
+    }
+    return 0;
+}
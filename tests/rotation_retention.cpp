@@ -0,0 +1,163 @@
+/**
+ * @file rotation_retention.cpp
+ * @brief Test: rotating_file_sink keeps the newest closed segments and deletes older ones
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+    LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+    Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+    Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 3 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+    USA
+*/
+
+
+
+#include "rotating_file_sink.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <dirent.h>
+#include <unistd.h>
+}
+
+
+namespace {
+
+int failures = 0;
+
+void expect( bool condition, const std::string& what ) {
+    if ( !condition ) {
+        std::cerr << "rotation_retention: " << what << std::endl;
+        failures++;
+    }
+}
+
+/**
+ * @returns The names of all entries in a directory except . and .., sorted
+ */
+std::vector< std::string > list( const std::string& directory ) {
+    std::vector< std::string > names;
+    DIR* dir = ::opendir( directory.c_str() );
+    while ( dir != nullptr ) {
+        struct dirent* entry = ::readdir( dir );
+        if ( entry == nullptr ) {
+            ::closedir( dir );
+            break;
+        }
+        const std::string name = entry->d_name;
+        if ( name != "." && name != ".." ) {
+            names.push_back( name );
+        }
+    }
+    std::sort( names.begin(), names.end() );
+    return names;
+}
+
+void remove_all( const std::string& directory ) {
+    for ( const std::string& name : list( directory ) ) {
+        ::unlink( ( directory + "/" + name ).c_str() );
+    }
+    ::rmdir( directory.c_str() );
+}
+
+/**
+ * @brief Write records "0" to "count - 1" through a sink rolling over after about 8 records
+ */
+void write_records( const std::string& path, std::size_t max_segments, bool compress, int count ) {
+    logcpp::rotating_file_sink out( path, logcpp::rotation_policy( 64, std::chrono::seconds( 0 ), max_segments, compress ) );
+    for ( int i = 0; i < count; i++ ) {
+        const std::string body = std::to_string( 1000 + i );
+        logcpp::record_view record = { body.data(), 0, body.data(), body.size(), true, logcpp::record_view::no_severity };
+        out.write( record );
+    }
+}   // The destructor waits for the background thread
+
+
+void test_keeps_newest( const std::string& directory ) {
+    const std::string path = directory + "/app.log";
+    const int count = 200;
+    write_records( path, 3, false, count );
+
+    const std::vector< std::string > names = list( directory );
+    expect( names.size() == 4, "kept " + std::to_string( names.size() ) + " files instead of app.log and 3 segments" );
+    if ( names.empty() || names.front() != "app.log" ) {
+        expect( false, "app.log is missing" );
+        return;
+    }
+
+    // The segments sort from old to new and continue with app.log up to the last record
+    std::vector< int > records;
+    for ( std::size_t i = 1; i <= names.size(); i++ ) {
+        std::ifstream in( directory + "/" + names[i % names.size()] );
+        std::string line;
+        while ( std::getline( in, line ) ) {
+            records.push_back( std::atoi( line.c_str() ) );
+        }
+    }
+    expect( !records.empty() && records.back() == 1000 + count - 1, "the newest record is missing" );
+    for ( std::size_t i = 1; i < records.size(); i++ ) {
+        if ( records[i] != records[i - 1] + 1 ) {
+            expect( false, "the kept files are not the newest: record " + std::to_string( records[i] ) + " follows " + std::to_string( records[i - 1] ) );
+            break;
+        }
+    }
+    remove_all( directory );
+}
+
+
+void test_keeps_newest_compressed( const std::string& directory ) {
+    if ( !logcpp::rotating_file_sink::compression_supported() ) {
+        return;
+    }
+    const std::string path = directory + "/app.log";
+    write_records( path, 2, true, 200 );
+
+    const std::vector< std::string > names = list( directory );
+    expect( names.size() == 3, "compressed: kept " + std::to_string( names.size() ) + " files instead of app.log and 2 segments" );
+    for ( std::size_t i = 1; i < names.size(); i++ ) {
+        expect( names[i].size() > 3 && names[i].compare( names[i].size() - 3, 3, ".gz" ) == 0, "compressed: " + names[i] + " is not compressed" );
+    }
+    remove_all( directory );
+}
+
+} // namespace
+
+
+int main() {
+    char directory[] = "/tmp/logcpp_rotation_XXXXXX";
+    if ( ::mkdtemp( directory ) == nullptr ) {
+        std::cerr << "rotation_retention: cannot create a temporary directory" << std::endl;
+        return 1;
+    }
+    test_keeps_newest( directory );
+
+    char compressed[] = "/tmp/logcpp_rotation_XXXXXX";
+    if ( ::mkdtemp( compressed ) == nullptr ) {
+        std::cerr << "rotation_retention: cannot create a temporary directory" << std::endl;
+        return 1;
+    }
+    test_keeps_newest_compressed( compressed );
+    remove_all( compressed );
+    return ( failures == 0 ? 0 : 1 );
+}
@@ -0,0 +1,66 @@
+/**
+ * @file severity_constants.cpp
+ * @brief Test: Severity macros that are kept stay constant expressions
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+    LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+    Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+    Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 3 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+    USA
+*/
+
+
+
+#include "severity_logger.hpp"
+
+#include <iostream>
+
+
+// Outside of any function, where __func__ is not defined
+static const logcpp::default_severity_levels default_level = WARNING;
+
+static_assert( WARNING == logcpp::warning, "WARNING is no constant expression" );
+static_assert( VERBOSE == logcpp::verbose && VERBOSE2 == logcpp::verbose2, "VERBOSE is no constant expression" );
+static_assert( DEBUG == logcpp::debug, "DEBUG is no constant expression" );
+
+
+namespace {
+
+int rank( logcpp::default_severity_levels level ) {
+    switch ( level ) {
+    case WARNING:
+        return 1;
+    case VERBOSE:
+        return 2;
+    case DEBUG:
+        return 3;
+    default:
+        return 0;
+    }
+}
+
+} // namespace
+
+
+int main() {
+    if ( rank( default_level ) != 1 || rank( DEBUG ) != 3 ) {
+        std::cerr << "severity_constants: the severity macros select the wrong case" << std::endl;
+        return 1;
+    }
+    return 0;
+}
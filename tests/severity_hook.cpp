@@ -0,0 +1,81 @@
+/**
+ * @file severity_hook.cpp
+ * @brief Test: A class inheriting from severity_log can override log_severity
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+    LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+    Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+    Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 3 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+    USA
+*/
+
+
+
+#include "severity_log.hpp"
+#include "severity_default.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+
+namespace {
+
+/**
+ * @brief A logger that marks each severity it begins a record with
+ */
+class marking_log
+    :    public logcpp::severity_log< logcpp::default_severity_levels >
+{
+public:
+    explicit marking_log( std::streambuf* outbuf )
+        :    logcpp::severity_log< logcpp::default_severity_levels >( &logcpp::DefaultSeverity::instance, logcpp::debug2, outbuf )
+        ,    marks( 0 )
+    {}
+
+    int marks;
+
+protected:
+    void log_severity( const logcpp::default_severity_levels severity ) override {
+        marks++;
+        logcpp::severity_log< logcpp::default_severity_levels >::log_severity( severity );
+        this->log< std::string >( "[marked] " );
+    }
+};
+
+} // namespace
+
+
+int main() {
+    std::ostringstream out;
+    marking_log lg( out.rdbuf() );
+    logcpp::severity_log< logcpp::default_severity_levels >& base = lg;
+
+    lg << logcpp::warning << "through the class" << logcpp::endrec;
+    base << logcpp::error << "through the base" << logcpp::endrec;
+
+    if ( lg.marks != 2 ) {
+        std::cerr << "severity_hook: log_severity was overridden, but called " << lg.marks << " of 2 times" << std::endl;
+        return 1;
+    }
+    if ( out.str().find( "[marked] through the base" ) == std::string::npos ) {
+        std::cerr << "severity_hook: the override did not insert into the record: \"" << out.str() << "\"" << std::endl;
+        return 1;
+    }
+    return 0;
+}
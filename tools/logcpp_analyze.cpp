@@ -0,0 +1,480 @@
+/**
+ * @file logcpp_analyze.cpp
+ * @brief Filters and counts records of text logs written by liblogcpp in parallel
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+    LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+    Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+    Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 3 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+    USA
+*/
+
+
+
+#include "severity_default.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace {
+
+/**
+ * @brief The parts of the first line of a record as written by basic_log and severity_log
+ */
+struct record_head {
+    const char* time;
+    std::size_t time_size;
+    int severity;               ///< -1, if the record has no severity
+    const char* site;           ///< file:line
+    std::size_t site_size;
+};
+
+/**
+ * @brief What records are selected
+ */
+struct filter {
+    int max_severity;           ///< -1 disables the severity filter
+    std::string since;
+    std::string until;
+    std::string scope_file;
+    std::string scope_line;     ///< Empty matches all lines
+    std::string text;
+    bool count;
+};
+
+/**
+ * @brief Results of one chunk
+ */
+struct chunk_result {
+    std::vector< std::pair< const char*, std::size_t > > records;
+    std::size_t severities[logcpp::SEVERITY_SIZE + 1];
+    std::unordered_map< std::string_view, std::size_t > sites;
+    std::pair< const std::string_view, std::size_t >* last_site;
+    std::size_t matched;
+};
+
+const std::size_t no_severity_index = logcpp::SEVERITY_SIZE;
+
+
+/**
+ * @returns The index of the severity named name or -1
+ */
+int severity_index( const char* name, std::size_t size ) {
+    for ( int i = 0; i < logcpp::SEVERITY_SIZE; i++ ) {
+        const std::string_view candidate = logcpp::DefaultSeverity::name( static_cast< logcpp::default_severity_levels >( i ) );
+        if ( candidate.size() == size && std::memcmp( candidate.data(), name, size ) == 0 ) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+
+/**
+ * @brief Parse the line [begin, end) as first line of a record like `[%F_%T] - <severity>: [ file:line ] : message`
+ * @returns False, if the line has neither a timestamp nor a severity and thus continues the previous record
+ */
+bool parse_head( const char* begin, const char* end, record_head& head ) {
+    const char* p = begin;
+    head.time = nullptr;
+    head.time_size = 0;
+    head.severity = -1;
+    head.site = nullptr;
+    head.site_size = 0;
+
+    if ( p < end && *p == '[' && p + 1 < end && *( p + 1 ) >= '0' && *( p + 1 ) <= '9' ) {
+        const char* close = static_cast< const char* >( std::memchr( p, ']', end - p ) );
+        if ( close != nullptr && end - close >= 4 && std::memcmp( close, "] - ", 4 ) == 0 ) {
+            head.time = p + 1;
+            head.time_size = close - p - 1;
+            p = close + 4;
+        }
+    }
+
+    const char* q = p;
+    while ( q < end && *q == ' ' ) {
+        q++;
+    }
+    if ( q < end && *q == '<' ) {
+        const char* close = static_cast< const char* >( std::memchr( q, '>', end - q ) );
+        if ( close != nullptr && end - close >= 3 && close[1] == ':' && close[2] == ' ' ) {
+            head.severity = severity_index( q + 1, close - q - 1 );
+            if ( head.severity >= 0 ) {
+                p = close + 3;
+            }
+        }
+    }
+
+    if ( end - p >= 2 && std::memcmp( p, "[ ", 2 ) == 0 ) {
+        const char* close = static_cast< const char* >( std::memchr( p, ']', end - p ) );
+        if ( close != nullptr && close - p >= 3 && *( close - 1 ) == ' ' ) {
+            head.site = p + 2;
+            head.site_size = close - p - 3;
+        }
+    }
+
+    return head.time != nullptr || head.severity >= 0;
+}
+
+
+/**
+ * @returns The beginning of the line after p or end
+ */
+const char* next_line( const char* p, const char* end ) {
+    const char* newline = static_cast< const char* >( std::memchr( p, '\n', end - p ) );
+    return newline == nullptr ? end : newline + 1;
+}
+
+
+/**
+ * @returns The first record head at or after p that begins a line
+ */
+const char* next_record( const char* begin, const char* p, const char* end ) {
+    if ( p > begin && *( p - 1 ) != '\n' ) {
+        p = next_line( p, end );
+    }
+    record_head head;
+    while ( p < end && !parse_head( p, next_line( p, end ), head ) ) {
+        p = next_line( p, end );
+    }
+    return p;
+}
+
+
+/**
+ * @returns Wether the first line of a record passes the severity, time and scope filters
+ */
+bool matches( const filter& f, const record_head& head ) {
+    if ( f.max_severity >= 0 && ( head.severity < 0 || head.severity > f.max_severity ) ) {
+        return false;
+    }
+    if ( !f.since.empty() || !f.until.empty() ) {
+        if ( head.time == nullptr ) {
+            return false;
+        }
+        std::string_view time( head.time, head.time_size );
+        if ( !f.since.empty() && time.substr( 0, f.since.size() ).compare( f.since ) < 0 ) {
+            return false;
+        }
+        if ( !f.until.empty() && time.substr( 0, f.until.size() ).compare( f.until ) > 0 ) {
+            return false;
+        }
+    }
+    if ( !f.scope_file.empty() ) {
+        if ( head.site == nullptr ) {
+            return false;
+        }
+        const char* colon = static_cast< const char* >( std::memchr( head.site, ':', head.site_size ) );
+        if ( colon == nullptr ) {
+            return false;
+        }
+        std::size_t file_size = colon - head.site;
+        std::size_t line_size = head.site_size - file_size - 1;
+        if ( file_size != f.scope_file.size() || std::memcmp( head.site, f.scope_file.data(), file_size ) != 0 ) {
+            return false;
+        }
+        if ( !f.scope_line.empty() && ( line_size != f.scope_line.size() || std::memcmp( colon + 1, f.scope_line.data(), line_size ) != 0 ) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/**
+ * @brief Finds the text filter with one search over the chunk instead of one search per record
+ */
+struct text_search {
+    const filter& f;
+    const char* limit;
+    const char* hit;            ///< The next occurrence at or after the current record or limit
+    const char* searched;       ///< Where hit was searched from
+
+    text_search( const filter& filter, const char* limit )
+        :   f( filter )
+        ,   limit( limit )
+        ,   hit( nullptr )
+        ,   searched( nullptr )
+    {}
+
+    /**
+     * @returns Wether the record [begin, end) contains the text
+     */
+    bool contains( const char* begin, const char* end ) {
+        if ( f.text.empty() ) {
+            return true;
+        }
+        if ( searched == nullptr || hit < begin ) {
+            hit = static_cast< const char* >( memmem( begin, limit - begin, f.text.data(), f.text.size() ) );
+            if ( hit == nullptr ) {
+                hit = limit;
+            }
+            searched = begin;
+        }
+        return hit + f.text.size() <= end;
+    }
+};
+
+
+/**
+ * @brief Count or collect a record that passed the filter
+ */
+void take( const filter& f, const record_head& head, const char* begin, const char* end, chunk_result& result ) {
+    result.matched++;
+    if ( f.count ) {
+        result.severities[head.severity >= 0 ? head.severity : no_severity_index]++;
+        if ( head.site != nullptr ) {
+            std::string_view site( head.site, head.site_size );
+            if ( result.last_site == nullptr || result.last_site->first != site ) {
+                result.last_site = &*result.sites.insert( std::make_pair( site, std::size_t( 0 ) ) ).first;
+            }
+            result.last_site->second++;     // Records of one site tend to follow each other
+        }
+    } else if ( !result.records.empty() && result.records.back().first + result.records.back().second == begin ) {
+        result.records.back().second += end - begin;
+    } else {
+        result.records.push_back( std::make_pair( begin, static_cast< std::size_t >( end - begin ) ) );
+    }
+}
+
+
+/**
+ * @brief Filter all records that begin in [begin, end). The last record may reach up to limit.
+ */
+void analyze( const filter& f, const char* begin, const char* end, const char* limit, chunk_result& result ) {
+    std::fill( result.severities, result.severities + logcpp::SEVERITY_SIZE + 1, 0 );
+    result.matched = 0;
+    result.last_site = nullptr;
+    if ( begin == end ) {
+        return;
+    }
+
+    text_search search( f, limit );
+    record_head head;
+    parse_head( begin, next_line( begin, limit ), head );
+    const char* record = begin;
+    const char* p = next_line( begin, limit );
+
+    // Each line is parsed once: it either begins the next record or continues the current one
+    while ( p < limit ) {
+        const char* line_end = next_line( p, limit );
+        record_head next;
+        if ( parse_head( p, line_end, next ) ) {
+            if ( matches( f, head ) && search.contains( record, p ) ) {
+                take( f, head, record, p, result );
+            }
+            if ( p >= end ) {
+                return;
+            }
+            head = next;
+            record = p;
+        }
+        p = line_end;
+    }
+    if ( matches( f, head ) && search.contains( record, p ) ) {
+        take( f, head, record, p, result );
+    }
+}
+
+
+void usage( const char* name ) {
+    std::fprintf( stderr,
+        "Usage: %s [OPTION]... FILE...\n"
+        "Filters records of text logs written by liblogcpp, splitting each file across threads.\n"
+        "\n"
+        "  -s, --severity LEVEL   Only records with a severity at most as verbose as LEVEL (like warning)\n"
+        "      --since TIME       Only records with a timestamp not before TIME (same layout as in the log)\n"
+        "      --until TIME       Only records with a timestamp not after TIME (prefixes match, like 2021-07-18_12)\n"
+        "      --scope FILE[:LINE] Only records inserted with SCOPE at FILE (and LINE)\n"
+        "  -e, --grep TEXT        Only records containing TEXT\n"
+        "  -c, --count            Print the amount of records per severity and per site instead of the records\n"
+        "  -j, --jobs N           Use N threads (defaults to the amount of cores)\n",
+        name );
+}
+
+} // namespace
+
+
+int main( int argc, char** argv ) {
+    filter f;
+    f.max_severity = -1;
+    f.count = false;
+    unsigned int jobs = std::thread::hardware_concurrency();
+    std::vector< std::string > files;
+
+    for ( int i = 1; i < argc; i++ ) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if ( ( arg == "-s" || arg == "--severity" ) && has_value ) {
+            std::string level = argv[++i];
+            f.max_severity = severity_index( level.data(), level.size() );
+            if ( f.max_severity < 0 ) {
+                std::fprintf( stderr, "%s: unknown severity %s\n", argv[0], level.c_str() );
+                return 2;
+            }
+        } else if ( arg == "--since" && has_value ) {
+            f.since = argv[++i];
+        } else if ( arg == "--until" && has_value ) {
+            f.until = argv[++i];
+        } else if ( arg == "--scope" && has_value ) {
+            std::string scope = argv[++i];
+            std::string::size_type colon = scope.find_last_of( ':' );
+            if ( colon != std::string::npos && colon + 1 < scope.size() && scope.find_first_not_of( "0123456789", colon + 1 ) == std::string::npos ) {
+                f.scope_file = scope.substr( 0, colon );
+                f.scope_line = scope.substr( colon + 1 );
+            } else {
+                f.scope_file = scope;
+            }
+        } else if ( ( arg == "-e" || arg == "--grep" ) && has_value ) {
+            f.text = argv[++i];
+        } else if ( arg == "-c" || arg == "--count" ) {
+            f.count = true;
+        } else if ( ( arg == "-j" || arg == "--jobs" ) && has_value ) {
+            jobs = static_cast< unsigned int >( std::atoi( argv[++i] ) );
+        } else if ( arg == "-h" || arg == "--help" ) {
+            usage( argv[0] );
+            return 0;
+        } else if ( !arg.empty() && arg[0] == '-' ) {
+            usage( argv[0] );
+            return 2;
+        } else {
+            files.push_back( arg );
+        }
+    }
+    if ( files.empty() ) {
+        usage( argv[0] );
+        return 2;
+    }
+    if ( jobs == 0 ) {
+        jobs = 1;
+    }
+
+    std::size_t severities[logcpp::SEVERITY_SIZE + 1] = {};
+    std::map< std::string, std::size_t > sites;
+    std::size_t matched = 0;
+    int status = 0;
+
+    for ( std::size_t n = 0; n < files.size(); n++ ) {
+        int fd = open( files[n].c_str(), O_RDONLY );
+        struct stat info;
+        if ( fd < 0 || fstat( fd, &info ) != 0 ) {
+            std::fprintf( stderr, "%s: cannot open %s\n", argv[0], files[n].c_str() );
+            status = 1;
+            if ( fd >= 0 ) {
+                close( fd );
+            }
+            continue;
+        }
+        std::size_t size = static_cast< std::size_t >( info.st_size );
+        if ( size == 0 ) {
+            close( fd );
+            continue;
+        }
+        void* mapping = mmap( nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+        close( fd );
+        if ( mapping == MAP_FAILED ) {
+            std::fprintf( stderr, "%s: cannot map %s\n", argv[0], files[n].c_str() );
+            status = 1;
+            continue;
+        }
+        madvise( mapping, size, MADV_SEQUENTIAL );
+
+        const char* data = static_cast< const char* >( mapping );
+        const char* limit = data + size;
+
+        // Chunks begin at record heads, so multi-line records are never split
+        std::size_t chunks = std::min< std::size_t >( jobs, std::max< std::size_t >( 1, size >> 20 ) );
+        std::vector< const char* > bounds( chunks + 1 );
+        bounds[0] = data;
+        bounds[chunks] = limit;
+        for ( std::size_t i = 1; i < chunks; i++ ) {
+            bounds[i] = std::max( bounds[i - 1], next_record( data, data + size / chunks * i, limit ) );
+        }
+
+        std::vector< chunk_result > results( chunks );
+        std::vector< std::thread > threads;
+        for ( std::size_t i = 1; i < chunks; i++ ) {
+            threads.push_back( std::thread( analyze, std::cref( f ), bounds[i], bounds[i + 1], limit, std::ref( results[i] ) ) );
+        }
+        analyze( f, bounds[0], bounds[1], limit, results[0] );
+        for ( std::size_t i = 0; i < threads.size(); i++ ) {
+            threads[i].join();
+        }
+
+        for ( std::size_t i = 0; i < chunks; i++ ) {
+            matched += results[i].matched;
+            for ( std::size_t j = 0; j <= logcpp::SEVERITY_SIZE; j++ ) {
+                severities[j] += results[i].severities[j];
+            }
+            for ( std::unordered_map< std::string_view, std::size_t >::const_iterator it = results[i].sites.begin(); it != results[i].sites.end(); ++it ) {
+                sites[std::string( it->first )] += it->second;
+            }
+            for ( std::size_t j = 0; j < results[i].records.size(); j++ ) {
+                std::fwrite( results[i].records[j].first, 1, results[i].records[j].second, stdout );
+            }
+        }
+
+        munmap( mapping, size );
+    }
+
+    if ( f.count ) {
+        std::printf( "records: %zu\n", matched );
+        std::printf( "per severity:\n" );
+        for ( int i = 0; i < logcpp::SEVERITY_SIZE; i++ ) {
+            if ( severities[i] > 0 ) {
+                const std::string_view name = logcpp::DefaultSeverity::name( static_cast< logcpp::default_severity_levels >( i ) );
+                std::printf( "  %.*s: %zu\n", static_cast< int >( name.size() ), name.data(), severities[i] );
+            }
+        }
+        if ( severities[no_severity_index] > 0 ) {
+            std::printf( "  (none): %zu\n", severities[no_severity_index] );
+        }
+
+        std::vector< std::pair< std::size_t, std::string > > ranked;
+        for ( std::map< std::string, std::size_t >::const_iterator it = sites.begin(); it != sites.end(); ++it ) {
+            ranked.push_back( std::make_pair( it->second, it->first ) );
+        }
+        std::sort( ranked.begin(), ranked.end(), []( const std::pair< std::size_t, std::string >& a, const std::pair< std::size_t, std::string >& b ) {
+            return a.first != b.first ? a.first > b.first : a.second < b.second;
+        } );
+        if ( !ranked.empty() ) {
+            std::printf( "per site:\n" );
+        }
+        for ( std::size_t i = 0; i < ranked.size(); i++ ) {
+            std::printf( "  %s: %zu\n", ranked[i].second.c_str(), ranked[i].first );
+        }
+    }
+
+    std::fflush( stdout );
+    return status;
+}
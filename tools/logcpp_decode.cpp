@@ -0,0 +1,213 @@
+/**
+ * @file logcpp_decode.cpp
+ * @brief Decodes a binary log stream written with enable_binary_records() to the text layout of liblogcpp
+ * @author Sebastian Lau <lauseb644 [at] gmail [dot] com>
+ **/
+/*
+    LibLogC++: An intuitive and highly customizable LGPL library for logging with C++.
+    Copyright (C) 2015 Linux Gruppe IRB, TU Dortmund <linux@irb.cs.tu-dortmund.de>
+    Copyright (C) 2015-2021 Sebastian Lau <lauseb644@gmail.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 3 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+    USA
+*/
+
+
+
+#include "binary_record.hpp"
+#include "severity_default.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <utility>
+
+
+namespace {
+
+/**
+ * @brief Read a value of type T at offset pos of data
+ */
+template< typename T >
+T read( const std::string& data, std::size_t pos ) {
+    T value;
+    std::memcpy( &value, data.data() + pos, sizeof( T ) );
+    return value;
+}
+
+
+/**
+ * @brief Print the arguments of a record
+ * @returns False, if the record is malformed
+ */
+bool print_arguments( std::ostream& out, const std::string& data, std::size_t pos, std::size_t end,
+                      const std::map< std::uint32_t, std::pair< std::string, std::uint32_t > >& sites ) {
+    while ( pos < end ) {
+        char type = data[pos++];
+        switch ( type ) {
+            case logcpp::binary_int:
+                if ( end - pos < 8 ) return false;
+                out << read< std::int64_t >( data, pos );
+                pos += 8;
+                break;
+            case logcpp::binary_uint:
+                if ( end - pos < 8 ) return false;
+                out << read< std::uint64_t >( data, pos );
+                pos += 8;
+                break;
+            case logcpp::binary_double:
+                if ( end - pos < 8 ) return false;
+                out << read< double >( data, pos );
+                pos += 8;
+                break;
+            case logcpp::binary_bool:
+                if ( end - pos < 1 ) return false;
+                out << ( data[pos] != 0 );
+                pos += 1;
+                break;
+            case logcpp::binary_char:
+                if ( end - pos < 1 ) return false;
+                out << data[pos];
+                pos += 1;
+                break;
+            case logcpp::binary_text: {
+                if ( end - pos < 4 ) return false;
+                std::uint32_t length = read< std::uint32_t >( data, pos );
+                pos += 4;
+                if ( end - pos < length ) return false;
+                out.write( data.data() + pos, length );
+                pos += length;
+                break;
+            }
+            case logcpp::binary_site: {
+                if ( end - pos < 4 ) return false;
+                std::map< std::uint32_t, std::pair< std::string, std::uint32_t > >::const_iterator it = sites.find( read< std::uint32_t >( data, pos ) );
+                pos += 4;
+                if ( it == sites.end() ) {
+                    out << "[ ?:? ] : ";
+                } else {
+                    out << "[ " << it->second.first << ":" << it->second.second << " ] : ";
+                }
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+
+int main( int argc, char** argv ) {
+    if ( argc > 2 || ( argc == 2 && ( std::strcmp( argv[1], "-h" ) == 0 || std::strcmp( argv[1], "--help" ) == 0 ) ) ) {
+        std::cerr << "Usage: " << argv[0] << " [FILE]" << std::endl
+                  << "Decodes a binary log written by liblogcpp from FILE or standard input to text." << std::endl;
+        return 2;
+    }
+
+    std::string data;
+    if ( argc == 2 ) {
+        std::ifstream file( argv[1], std::ios::binary );
+        if ( !file ) {
+            std::cerr << argv[0] << ": cannot open " << argv[1] << std::endl;
+            return 1;
+        }
+        data.assign( std::istreambuf_iterator< char >( file ), std::istreambuf_iterator< char >() );
+    } else {
+        data.assign( std::istreambuf_iterator< char >( std::cin ), std::istreambuf_iterator< char >() );
+    }
+
+    logcpp::DefaultSeverity severities;
+    std::map< std::uint32_t, std::pair< std::string, std::uint32_t > > sites;
+    std::ostream& out = std::cout;
+    bool header = false;
+    std::size_t pos = 0;
+
+    while ( pos < data.size() ) {
+        if ( data.size() - pos < logcpp::binary_frame_header_size ) {
+            std::cerr << argv[0] << ": truncated frame at offset " << pos << std::endl;
+            return 1;
+        }
+        char type = data[pos];
+        std::uint32_t size = read< std::uint32_t >( data, pos + 1 );
+        std::size_t payload = pos + logcpp::binary_frame_header_size;
+        if ( data.size() - payload < size ) {
+            std::cerr << argv[0] << ": truncated frame at offset " << pos << std::endl;
+            return 1;
+        }
+        pos = payload + size;
+
+        if ( type == logcpp::binary_frame_stream ) {
+            if ( size != sizeof( logcpp::binary_magic ) + sizeof( logcpp::binary_byte_order )
+              || std::memcmp( data.data() + payload, logcpp::binary_magic, sizeof( logcpp::binary_magic ) ) != 0 ) {
+                std::cerr << argv[0] << ": not a binary log of liblogcpp" << std::endl;
+                return 1;
+            }
+            if ( read< std::uint32_t >( data, payload + sizeof( logcpp::binary_magic ) ) != logcpp::binary_byte_order ) {
+                std::cerr << argv[0] << ": the log was written on a machine with a different byte order" << std::endl;
+                return 1;
+            }
+            header = true;
+            continue;
+        }
+        if ( !header ) {
+            std::cerr << argv[0] << ": not a binary log of liblogcpp" << std::endl;
+            return 1;
+        }
+
+        if ( type == logcpp::binary_frame_site && size >= 8 ) {
+            std::uint32_t id = read< std::uint32_t >( data, payload );
+            std::uint32_t line = read< std::uint32_t >( data, payload + 4 );
+            sites[id] = std::make_pair( data.substr( payload + 8, size - 8 ), line );
+        } else if ( type == logcpp::binary_frame_record && size >= logcpp::binary_record_header_size ) {
+            std::int64_t nanos = read< std::int64_t >( data, payload + 4 );
+            std::int32_t severity = read< std::int32_t >( data, payload + 12 );
+            unsigned char flags = static_cast< unsigned char >( data[payload + 16] );
+
+            if ( flags & logcpp::binary_flag_timestamp ) {
+                char stamp[logcpp::max_timestamp_size];
+                std::chrono::system_clock::time_point time( std::chrono::duration_cast< std::chrono::system_clock::duration >( std::chrono::nanoseconds( nanos ) ) );
+                std::size_t length = logcpp::format_timestamp( stamp, time
+                                                             , static_cast< logcpp::timestamp_format >( data[payload + 17] )
+                                                             , static_cast< logcpp::timestamp_precision >( data[payload + 18] ) );
+                out << "[";
+                out.write( stamp, length );
+                out << "] - ";
+            }
+            if ( flags & logcpp::binary_flag_severity ) {
+                logcpp::default_severity_levels level = static_cast< logcpp::default_severity_levels >( severity );
+                out << severities.prefix( level );
+            }
+            if ( !print_arguments( out, data, payload + logcpp::binary_record_header_size, pos, sites ) ) {
+                std::cerr << argv[0] << ": malformed record at offset " << payload - logcpp::binary_frame_header_size << std::endl;
+                return 1;
+            }
+            out << "\n";
+        } else {
+            std::cerr << argv[0] << ": unknown frame at offset " << payload - logcpp::binary_frame_header_size << std::endl;
+            return 1;
+        }
+    }
+
+    out.flush();
+    return 0;
+}